@@ -119,6 +119,69 @@ void drawAllShapes(std::vector<std::unique_ptr<Shape>> const& shapes)
     }
 }
 
+// Batched dispatch over a shape collection
+// Keeps per-type bucket indices: every shape is classified once (one accept each), then
+// dispatch() runs each visit overload over a homogeneous run of shapes. The indirect call
+// target stays the same for a whole bucket, so mixed collections no longer mispredict on
+// almost every element. Shapes are visited grouped by type, not in collection order, so
+// use it for operations that do not depend on the order.
+class ShapeBuckets
+{
+public:
+    explicit ShapeBuckets(std::vector<std::unique_ptr<Shape>> const& shapes)
+    {
+        rebuild(shapes);
+    }
+
+    // Re-classify after the collection changed
+    void rebuild(std::vector<std::unique_ptr<Shape>> const& shapes)
+    {
+        _circles.clear();
+        _squares.clear();
+        Classify classify{this};
+        for (auto const& s : shapes)
+        {
+            s->accept(classify);
+        }
+    }
+
+    // Runs the visitor over all circles, then over all squares
+    void dispatch(ShapeVisitor const& v) const
+    {
+        for (Circle const* c : _circles)
+        {
+            v.visit(*c);
+        }
+        for (Square const* s : _squares)
+        {
+            v.visit(*s);
+        }
+    }
+
+private:
+    // Visitor that files each shape into its bucket
+    class Classify : public ShapeVisitor
+    {
+    public:
+        explicit Classify(ShapeBuckets* buckets) : _buckets{buckets} {}
+
+        void visit(Circle const& c) const override { _buckets->_circles.push_back(&c); }
+        void visit(Square const& s) const override { _buckets->_squares.push_back(&s); }
+
+    private:
+        ShapeBuckets* _buckets;
+    };
+
+    std::vector<Circle const*> _circles; // Non-owning; valid while the collection is unchanged
+    std::vector<Square const*> _squares;
+};
+
+// Draws all shapes type by type through the bucket indices
+void drawAllShapesBatched(ShapeBuckets const& buckets)
+{
+    buckets.dispatch(Draw{});
+}
+
 int main()
 {
     using Shapes = std::vector<std::unique_ptr<Shape>>;
@@ -132,5 +195,10 @@ int main()
     // Drawing all shapes using the Visitor Pattern
     drawAllShapes(shapes);
 
+    // Same operations, dispatched type by type
+    ShapeBuckets buckets{shapes};
+    drawAllShapesBatched(buckets);
+    buckets.dispatch(Rotate{});
+
     return 0;
 }
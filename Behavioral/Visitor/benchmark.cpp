@@ -0,0 +1,760 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <variant>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/*
+    Benchmark of the four Visitor implementations in this directory:
+
+        DoubleDispatch.cpp             : virtual accept + virtual visit
+                                         (and "DoubleDispatch+": ShapeBuckets, type-batched)
+        variantApproach.cpp            : std::variant + std::visit
+        visitorCRTP.cpp                : CRTP accept, made heterogeneous with a tag + pointer
+        typeErasedCRTPWithVisitor.cpp  : ShapeWrapper (Concept/Model) over CRTP shapes
+
+    Each approach is rebuilt below in its own namespace, with real geometry instead of printing,
+    and runs the same three operations over the same shapes:
+
+        area  : sum of the areas                    (read only)
+        rotate: rotate every shape about the origin (read/write)
+        bbox  : bounding box of all the shapes      (read only)
+
+    Shapes are half circles, half squares, either grouped by type ("homogeneous") or randomly
+    interleaved ("shuffled"). Reported per shape visited: time, and branch / cache misses from
+    the hardware counters (perf_event_open on Linux; "n/a" where unavailable).
+
+    Usage: benchmark [shape counts...]   (default: 1000 1000000; e.g. add 100000000)
+*/
+
+// Geometry shared by every approach
+struct Box
+{
+    double minX = HUGE_VAL, minY = HUGE_VAL, maxX = -HUGE_VAL, maxY = -HUGE_VAL;
+
+    void add(double x, double y, double halfWidth, double halfHeight)
+    {
+        minX = std::min(minX, x - halfWidth);
+        minY = std::min(minY, y - halfHeight);
+        maxX = std::max(maxX, x + halfWidth);
+        maxY = std::max(maxY, y + halfHeight);
+    }
+};
+
+struct CircleData
+{
+    double x, y, radius;
+};
+
+struct SquareData
+{
+    double x, y, side;
+    double cosA, sinA; // Orientation, kept as cosine/sine so no trigonometry runs in the loops
+};
+
+inline double area(CircleData const& c) { return 3.141592653589793 * c.radius * c.radius; }
+inline double area(SquareData const& s) { return s.side * s.side; }
+
+inline void rotate(CircleData& c, double cosT, double sinT)
+{
+    double x = c.x;
+    c.x = cosT * x - sinT * c.y;
+    c.y = sinT * x + cosT * c.y;
+}
+
+inline void rotate(SquareData& s, double cosT, double sinT)
+{
+    double x = s.x;
+    s.x = cosT * x - sinT * s.y;
+    s.y = sinT * x + cosT * s.y;
+    double cosA = s.cosA;
+    s.cosA = cosT * cosA - sinT * s.sinA;
+    s.sinA = sinT * cosA + cosT * s.sinA;
+}
+
+inline void bounds(CircleData const& c, Box& box) { box.add(c.x, c.y, c.radius, c.radius); }
+inline void bounds(SquareData const& s, Box& box)
+{
+    double half = 0.5 * s.side * (std::fabs(s.cosA) + std::fabs(s.sinA));
+    box.add(s.x, s.y, half, half);
+}
+
+// One shape of a workload, independent of the approach
+struct ShapeSpec
+{
+    bool isCircle;
+    CircleData circle;
+    SquareData square;
+};
+
+// DoubleDispatch.cpp: virtual accept on the shape, virtual visit on the visitor
+namespace doubleDispatch
+{
+class Circle;
+class Square;
+
+class ShapeVisitor
+{
+public:
+    virtual ~ShapeVisitor() = default;
+    virtual void visit(Circle&) = 0;
+    virtual void visit(Square&) = 0;
+};
+
+class Shape
+{
+public:
+    virtual ~Shape() = default;
+    virtual void accept(ShapeVisitor&) = 0;
+};
+
+class Circle : public Shape
+{
+public:
+    explicit Circle(CircleData d) : data{d} {}
+    void accept(ShapeVisitor& v) override { v.visit(*this); }
+    CircleData data;
+};
+
+class Square : public Shape
+{
+public:
+    explicit Square(SquareData d) : data{d} {}
+    void accept(ShapeVisitor& v) override { v.visit(*this); }
+    SquareData data;
+};
+
+class AreaSum : public ShapeVisitor
+{
+public:
+    void visit(Circle& c) override { sum += area(c.data); }
+    void visit(Square& s) override { sum += area(s.data); }
+    double sum = 0;
+};
+
+class Rotate : public ShapeVisitor
+{
+public:
+    Rotate(double cosT, double sinT) : _cos{cosT}, _sin{sinT} {}
+    void visit(Circle& c) override { rotate(c.data, _cos, _sin); }
+    void visit(Square& s) override { rotate(s.data, _cos, _sin); }
+
+private:
+    double _cos, _sin;
+};
+
+class BoundingBox : public ShapeVisitor
+{
+public:
+    void visit(Circle& c) override { bounds(c.data, box); }
+    void visit(Square& s) override { bounds(s.data, box); }
+    Box box;
+};
+
+struct Approach
+{
+    static constexpr const char* name = "DoubleDispatch";
+    using Shapes = std::vector<std::unique_ptr<Shape>>;
+
+    static Shapes make(std::vector<ShapeSpec> const& specs)
+    {
+        Shapes shapes;
+        shapes.reserve(specs.size());
+        for (auto const& spec : specs)
+        {
+            if (spec.isCircle)
+                shapes.emplace_back(std::make_unique<Circle>(spec.circle));
+            else
+                shapes.emplace_back(std::make_unique<Square>(spec.square));
+        }
+        return shapes;
+    }
+
+    static double areaSum(Shapes& shapes)
+    {
+        AreaSum v;
+        for (auto& s : shapes)
+            s->accept(v);
+        return v.sum;
+    }
+
+    static void rotateAll(Shapes& shapes, double cosT, double sinT)
+    {
+        Rotate v{cosT, sinT};
+        for (auto& s : shapes)
+            s->accept(v);
+    }
+
+    static Box boundingBox(Shapes& shapes)
+    {
+        BoundingBox v;
+        for (auto& s : shapes)
+            s->accept(v);
+        return v.box;
+    }
+};
+
+// ShapeBuckets from DoubleDispatch.cpp: classify once, then visit type by type
+struct BatchedApproach
+{
+    static constexpr const char* name = "DoubleDispatch+";
+
+    struct Shapes
+    {
+        Approach::Shapes owned;
+        std::vector<Circle*> circles;
+        std::vector<Square*> squares;
+    };
+
+    class Classify : public ShapeVisitor
+    {
+    public:
+        explicit Classify(Shapes& shapes) : _shapes{shapes} {}
+        void visit(Circle& c) override { _shapes.circles.push_back(&c); }
+        void visit(Square& s) override { _shapes.squares.push_back(&s); }
+
+    private:
+        Shapes& _shapes;
+    };
+
+    static Shapes make(std::vector<ShapeSpec> const& specs)
+    {
+        Shapes shapes{Approach::make(specs), {}, {}};
+        Classify classify{shapes};
+        for (auto& s : shapes.owned)
+            s->accept(classify);
+        return shapes;
+    }
+
+    static void dispatch(Shapes& shapes, ShapeVisitor& v)
+    {
+        for (Circle* c : shapes.circles)
+            v.visit(*c);
+        for (Square* s : shapes.squares)
+            v.visit(*s);
+    }
+
+    static double areaSum(Shapes& shapes)
+    {
+        AreaSum v;
+        dispatch(shapes, v);
+        return v.sum;
+    }
+
+    static void rotateAll(Shapes& shapes, double cosT, double sinT)
+    {
+        Rotate v{cosT, sinT};
+        dispatch(shapes, v);
+    }
+
+    static Box boundingBox(Shapes& shapes)
+    {
+        BoundingBox v;
+        dispatch(shapes, v);
+        return v.box;
+    }
+};
+} // namespace doubleDispatch
+
+// variantApproach.cpp: a closed set of shapes in std::variant, operations are std::visit visitors
+namespace variantApproach
+{
+struct Circle
+{
+    CircleData data;
+};
+
+struct Square
+{
+    SquareData data;
+};
+
+using Shape = std::variant<Circle, Square>;
+
+struct AreaSum
+{
+    double& sum;
+    void operator()(Circle const& c) const { sum += area(c.data); }
+    void operator()(Square const& s) const { sum += area(s.data); }
+};
+
+struct Rotate
+{
+    double cosT, sinT;
+    void operator()(Circle& c) const { rotate(c.data, cosT, sinT); }
+    void operator()(Square& s) const { rotate(s.data, cosT, sinT); }
+};
+
+struct BoundingBox
+{
+    Box& box;
+    void operator()(Circle const& c) const { bounds(c.data, box); }
+    void operator()(Square const& s) const { bounds(s.data, box); }
+};
+
+struct Approach
+{
+    static constexpr const char* name = "variant";
+    using Shapes = std::vector<Shape>;
+
+    static Shapes make(std::vector<ShapeSpec> const& specs)
+    {
+        Shapes shapes;
+        shapes.reserve(specs.size());
+        for (auto const& spec : specs)
+        {
+            if (spec.isCircle)
+                shapes.emplace_back(Circle{spec.circle});
+            else
+                shapes.emplace_back(Square{spec.square});
+        }
+        return shapes;
+    }
+
+    static double areaSum(Shapes& shapes)
+    {
+        double sum = 0;
+        for (auto const& s : shapes)
+            std::visit(AreaSum{sum}, s);
+        return sum;
+    }
+
+    static void rotateAll(Shapes& shapes, double cosT, double sinT)
+    {
+        for (auto& s : shapes)
+            std::visit(Rotate{cosT, sinT}, s);
+    }
+
+    static Box boundingBox(Shapes& shapes)
+    {
+        Box box;
+        for (auto const& s : shapes)
+            std::visit(BoundingBox{box}, s);
+        return box;
+    }
+};
+} // namespace variantApproach
+
+// visitorCRTP.cpp: statically dispatched accept. A heterogeneous sequence is a tag + pointer per
+// shape into per-type storage, dispatched through a per-visitor table of accept thunks.
+namespace visitorCRTP
+{
+template <typename Derived>
+class ShapeCRTP
+{
+public:
+    template <typename Visitor>
+    void accept(Visitor&& v)
+    {
+        v.visit(static_cast<Derived&>(*this)); // Static dispatch via CRTP
+    }
+};
+
+class Circle : public ShapeCRTP<Circle>
+{
+public:
+    explicit Circle(CircleData d) : data{d} {}
+    CircleData data;
+};
+
+class Square : public ShapeCRTP<Square>
+{
+public:
+    explicit Square(SquareData d) : data{d} {}
+    SquareData data;
+};
+
+struct AreaSum
+{
+    void visit(Circle const& c) { sum += area(c.data); }
+    void visit(Square const& s) { sum += area(s.data); }
+    double sum = 0;
+};
+
+struct Rotate
+{
+    void visit(Circle& c) { rotate(c.data, cosT, sinT); }
+    void visit(Square& s) { rotate(s.data, cosT, sinT); }
+    double cosT, sinT;
+};
+
+struct BoundingBox
+{
+    void visit(Circle const& c) { bounds(c.data, box); }
+    void visit(Square const& s) { bounds(s.data, box); }
+    Box box;
+};
+
+template <typename Visitor>
+using Thunk = void (*)(void*, Visitor&);
+
+template <typename T, typename Visitor>
+void acceptThunk(void* shape, Visitor& v)
+{
+    static_cast<T*>(shape)->accept(v);
+}
+
+// Indexed by ShapeRef::tag
+template <typename Visitor>
+constexpr Thunk<Visitor> dispatchTable[] = {&acceptThunk<Circle, Visitor>, &acceptThunk<Square, Visitor>};
+
+struct ShapeRef
+{
+    void* shape;
+    std::uint32_t tag; // 0 = Circle, 1 = Square
+};
+
+struct Approach
+{
+    static constexpr const char* name = "visitorCRTP";
+
+    struct Shapes
+    {
+        std::vector<Circle> circles;
+        std::vector<Square> squares;
+        std::vector<ShapeRef> order; // Points into circles/squares, which never grow afterwards
+    };
+
+    static Shapes make(std::vector<ShapeSpec> const& specs)
+    {
+        Shapes shapes;
+        std::size_t circleCount = std::count_if(specs.begin(), specs.end(), [](ShapeSpec const& s) { return s.isCircle; });
+        shapes.circles.reserve(circleCount);
+        shapes.squares.reserve(specs.size() - circleCount);
+        shapes.order.reserve(specs.size());
+        for (auto const& spec : specs)
+        {
+            if (spec.isCircle)
+            {
+                shapes.circles.emplace_back(spec.circle);
+                shapes.order.push_back({&shapes.circles.back(), 0});
+            }
+            else
+            {
+                shapes.squares.emplace_back(spec.square);
+                shapes.order.push_back({&shapes.squares.back(), 1});
+            }
+        }
+        return shapes;
+    }
+
+    template <typename Visitor>
+    static void visitAll(Shapes& shapes, Visitor& v)
+    {
+        for (auto const& ref : shapes.order)
+            dispatchTable<Visitor>[ref.tag](ref.shape, v);
+    }
+
+    static double areaSum(Shapes& shapes)
+    {
+        AreaSum v;
+        visitAll(shapes, v);
+        return v.sum;
+    }
+
+    static void rotateAll(Shapes& shapes, double cosT, double sinT)
+    {
+        Rotate v{cosT, sinT};
+        visitAll(shapes, v);
+    }
+
+    static Box boundingBox(Shapes& shapes)
+    {
+        BoundingBox v;
+        visitAll(shapes, v);
+        return v.box;
+    }
+};
+} // namespace visitorCRTP
+
+// typeErasedCRTPWithVisitor.cpp: CRTP shapes held by a Concept/Model type-erased ShapeWrapper
+namespace typeErased
+{
+template <typename Derived>
+class ShapeCRTP
+{
+public:
+    double area() const { return static_cast<Derived const*>(this)->area(); }
+};
+
+class Circle : public ShapeCRTP<Circle>
+{
+public:
+    explicit Circle(CircleData d) : data{d} {}
+    double area() const { return ::area(data); }
+    void rotate(double cosT, double sinT) { ::rotate(data, cosT, sinT); }
+    void bounds(Box& box) const { ::bounds(data, box); }
+    CircleData data;
+};
+
+class Square : public ShapeCRTP<Square>
+{
+public:
+    explicit Square(SquareData d) : data{d} {}
+    double area() const { return ::area(data); }
+    void rotate(double cosT, double sinT) { ::rotate(data, cosT, sinT); }
+    void bounds(Box& box) const { ::bounds(data, box); }
+    SquareData data;
+};
+
+class ShapeWrapper
+{
+public:
+    template <typename T>
+    ShapeWrapper(T shape) : _shape{std::make_unique<Model<T>>(std::move(shape))} {}
+
+    double area() const { return _shape->area(); }
+    void rotate(double cosT, double sinT) { _shape->rotate(cosT, sinT); }
+    void bounds(Box& box) const { _shape->bounds(box); }
+
+private:
+    struct Concept
+    {
+        virtual ~Concept() = default;
+        virtual double area() const = 0;
+        virtual void rotate(double cosT, double sinT) = 0;
+        virtual void bounds(Box& box) const = 0;
+    };
+
+    template <typename T>
+    struct Model : Concept
+    {
+        Model(T shape) : _shape{std::move(shape)} {}
+        double area() const override { return _shape.area(); }
+        void rotate(double cosT, double sinT) override { _shape.rotate(cosT, sinT); }
+        void bounds(Box& box) const override { _shape.bounds(box); }
+        T _shape;
+    };
+
+    std::unique_ptr<Concept> _shape;
+};
+
+struct Approach
+{
+    static constexpr const char* name = "typeErasedCRTP";
+    using Shapes = std::vector<ShapeWrapper>;
+
+    static Shapes make(std::vector<ShapeSpec> const& specs)
+    {
+        Shapes shapes;
+        shapes.reserve(specs.size());
+        for (auto const& spec : specs)
+        {
+            if (spec.isCircle)
+                shapes.emplace_back(Circle{spec.circle});
+            else
+                shapes.emplace_back(Square{spec.square});
+        }
+        return shapes;
+    }
+
+    static double areaSum(Shapes& shapes)
+    {
+        double sum = 0;
+        for (auto const& s : shapes)
+            sum += s.area();
+        return sum;
+    }
+
+    static void rotateAll(Shapes& shapes, double cosT, double sinT)
+    {
+        for (auto& s : shapes)
+            s.rotate(cosT, sinT);
+    }
+
+    static Box boundingBox(Shapes& shapes)
+    {
+        Box box;
+        for (auto const& s : shapes)
+            s.bounds(box);
+        return box;
+    }
+};
+} // namespace typeErased
+
+// Hardware event counter for the calling thread (user space only); unavailable off Linux or
+// when perf events are not permitted (e.g. perf_event_paranoid, containers)
+class PerfCounter
+{
+public:
+    explicit PerfCounter(std::uint64_t config)
+    {
+#ifdef __linux__
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        _fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#else
+        (void)config;
+#endif
+    }
+
+    ~PerfCounter()
+    {
+#ifdef __linux__
+        if (_fd >= 0)
+            close(_fd);
+#endif
+    }
+
+    PerfCounter(PerfCounter const&) = delete;
+    PerfCounter& operator=(PerfCounter const&) = delete;
+
+    bool available() const { return _fd >= 0; }
+
+    void start()
+    {
+#ifdef __linux__
+        if (_fd >= 0)
+        {
+            ioctl(_fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    // Events since start()
+    std::uint64_t stop()
+    {
+        std::uint64_t value = 0;
+#ifdef __linux__
+        if (_fd >= 0)
+        {
+            ioctl(_fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(_fd, &value, sizeof(value)) != static_cast<ssize_t>(sizeof(value)))
+                value = 0;
+        }
+#endif
+        return value;
+    }
+
+private:
+    int _fd = -1;
+};
+
+#ifdef __linux__
+constexpr std::uint64_t BranchMisses = PERF_COUNT_HW_BRANCH_MISSES;
+constexpr std::uint64_t CacheMisses = PERF_COUNT_HW_CACHE_MISSES;
+#else
+constexpr std::uint64_t BranchMisses = 0;
+constexpr std::uint64_t CacheMisses = 0;
+#endif
+
+// Per-shape cost of `passes` runs of `work` over `shapes` shapes (after one warm-up run)
+template <typename Work>
+void measure(char const* operation, std::size_t shapes, std::size_t passes, Work&& work)
+{
+    PerfCounter branchMisses{BranchMisses};
+    PerfCounter cacheMisses{CacheMisses};
+
+    work();
+    branchMisses.start();
+    cacheMisses.start();
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t p = 0; p < passes; ++p)
+        work();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::uint64_t branches = branchMisses.stop();
+    std::uint64_t caches = cacheMisses.stop();
+
+    double ops = static_cast<double>(shapes) * passes;
+    std::cout << "  " << std::left << std::setw(7) << operation << std::right << std::fixed << std::setprecision(3)
+              << std::setw(9) << seconds * 1e9 / ops << " ns/op";
+    if (branchMisses.available())
+        std::cout << std::setw(9) << branches / ops << " br-miss/op";
+    else
+        std::cout << std::setw(9) << "n/a" << " br-miss/op";
+    if (cacheMisses.available())
+        std::cout << std::setw(9) << caches / ops << " $-miss/op";
+    else
+        std::cout << std::setw(9) << "n/a" << " $-miss/op";
+}
+
+double volatile sink; // Keeps results observable
+
+template <typename Approach>
+void runApproach(std::vector<ShapeSpec> const& specs, double expectedArea)
+{
+    const std::size_t passes = std::max<std::size_t>(1, 20000000 / specs.size());
+    const double cosT = std::cos(1e-3), sinT = std::sin(1e-3);
+
+    std::cout << std::setw(16) << std::left << Approach::name << std::right;
+    {
+        typename Approach::Shapes shapes = Approach::make(specs);
+        double areaSum = Approach::areaSum(shapes);
+        measure("area", specs.size(), passes, [&] { sink = Approach::areaSum(shapes); });
+        std::cout << '\n' << std::setw(16) << "";
+        measure("rotate", specs.size(), passes, [&] { Approach::rotateAll(shapes, cosT, sinT); });
+        std::cout << '\n' << std::setw(16) << "";
+        measure("bbox", specs.size(), passes, [&] { sink = Approach::boundingBox(shapes).maxX; });
+        if (std::fabs(areaSum - expectedArea) > 1e-9 * std::fabs(expectedArea))
+            std::cout << "  (area mismatch)";
+        std::cout << std::endl;
+    }
+}
+
+// `count` shapes, half circles and half squares; grouped by type unless `shuffled`
+std::vector<ShapeSpec> makeSpecs(std::size_t count, bool shuffled)
+{
+    std::mt19937_64 random{12345};
+    std::uniform_real_distribution<double> position{-1000.0, 1000.0};
+    std::uniform_real_distribution<double> size{0.5, 10.0};
+    std::vector<ShapeSpec> specs(count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        specs[i].isCircle = i < count / 2;
+        specs[i].circle = {position(random), position(random), size(random)};
+        specs[i].square = {position(random), position(random), size(random), 1.0, 0.0};
+    }
+    if (shuffled)
+        std::shuffle(specs.begin(), specs.end(), random);
+    return specs;
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::size_t> counts;
+    for (int i = 1; i < argc; ++i)
+        counts.push_back(std::strtoull(argv[i], nullptr, 10));
+    if (counts.empty())
+        counts = {1000, 1000000};
+
+    for (std::size_t count : counts)
+    {
+        if (count == 0)
+            continue;
+        for (bool shuffled : {false, true})
+        {
+            std::vector<ShapeSpec> specs = makeSpecs(count, shuffled);
+            double expectedArea = 0;
+            for (auto const& spec : specs)
+                expectedArea += spec.isCircle ? area(spec.circle) : area(spec.square);
+
+            std::cout << "\n== " << count << " shapes, " << (shuffled ? "shuffled" : "homogeneous") << " ==" << std::endl;
+            runApproach<doubleDispatch::Approach>(specs, expectedArea);
+            runApproach<doubleDispatch::BatchedApproach>(specs, expectedArea);
+            runApproach<variantApproach::Approach>(specs, expectedArea);
+            runApproach<visitorCRTP::Approach>(specs, expectedArea);
+            runApproach<typeErased::Approach>(specs, expectedArea);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,384 @@
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SHAPE_BATCH_X86 1
+#include <immintrin.h>
+#endif
+
+/*
+    ShapeBatch : Shapes stored as a struct of arrays, processed by SIMD kernels.
+
+    With one object per shape (Circle::_radius, Square::_side), an operation touches one value
+    per object and cannot be vectorized. Here every attribute of every shape type has its own
+    contiguous array (positions, radii, sides, orientations), and each operation is a few
+    passes of a simple kernel over those arrays:
+
+        sum        : perimeter         (2*pi*sum(radius) + 4*sum(side))
+        sumSquares : area              (pi*sum(radius^2) + sum(side^2))
+        scale      : scaling           (positions and sizes times a factor)
+        rotate     : rotation          (positions, and the squares' orientation, about the origin)
+
+    Each kernel exists as AVX2 (4 doubles per instruction), SSE4.1 (2 doubles) and scalar code;
+    the best one the CPU supports is picked at runtime, so the binary does not need to be built
+    for a particular instruction set. The operations are exposed as visitors named like the
+    ones of the other Visitor examples (Draw, Rotate, ...), applied with visit(visitor, batch).
+*/
+
+// Concrete shapes, as in the other Visitor examples
+class Circle
+{
+public:
+    explicit Circle(double rad) : _radius{rad} {}
+    double radius() const { return _radius; }
+
+private:
+    double _radius; // Radius of the circle
+};
+
+class Square
+{
+public:
+    explicit Square(double s) : _side{s} {}
+    double side() const { return _side; }
+
+private:
+    double _side; // Side length of the square
+};
+
+// Kernel set for one instruction set
+struct Kernels
+{
+    const char* name;
+    double (*sum)(const double* v, std::size_t n);
+    double (*sumSquares)(const double* v, std::size_t n);
+    void (*scale)(double* v, std::size_t n, double factor);
+    void (*rotate)(double* x, double* y, std::size_t n, double cosT, double sinT); // (x, y) pairs
+};
+
+namespace scalar
+{
+double sum(const double* v, std::size_t n)
+{
+    double s = 0;
+    for (std::size_t i = 0; i < n; ++i)
+        s += v[i];
+    return s;
+}
+
+double sumSquares(const double* v, std::size_t n)
+{
+    double s = 0;
+    for (std::size_t i = 0; i < n; ++i)
+        s += v[i] * v[i];
+    return s;
+}
+
+void scale(double* v, std::size_t n, double factor)
+{
+    for (std::size_t i = 0; i < n; ++i)
+        v[i] *= factor;
+}
+
+void rotate(double* x, double* y, std::size_t n, double cosT, double sinT)
+{
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        double xi = x[i];
+        x[i] = cosT * xi - sinT * y[i];
+        y[i] = sinT * xi + cosT * y[i];
+    }
+}
+
+constexpr Kernels kernels{"scalar", &sum, &sumSquares, &scale, &rotate};
+} // namespace scalar
+
+#ifdef SHAPE_BATCH_X86
+namespace sse4
+{
+__attribute__((target("sse4.1"))) double sum(const double* v, std::size_t n)
+{
+    __m128d a = _mm_setzero_pd(), b = _mm_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        a = _mm_add_pd(a, _mm_loadu_pd(v + i));
+        b = _mm_add_pd(b, _mm_loadu_pd(v + i + 2));
+    }
+    a = _mm_add_pd(a, b);
+    double s = _mm_cvtsd_f64(a) + _mm_cvtsd_f64(_mm_unpackhi_pd(a, a));
+    return s + scalar::sum(v + i, n - i);
+}
+
+__attribute__((target("sse4.1"))) double sumSquares(const double* v, std::size_t n)
+{
+    __m128d a = _mm_setzero_pd(), b = _mm_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m128d x = _mm_loadu_pd(v + i), y = _mm_loadu_pd(v + i + 2);
+        a = _mm_add_pd(a, _mm_mul_pd(x, x));
+        b = _mm_add_pd(b, _mm_mul_pd(y, y));
+    }
+    a = _mm_add_pd(a, b);
+    double s = _mm_cvtsd_f64(a) + _mm_cvtsd_f64(_mm_unpackhi_pd(a, a));
+    return s + scalar::sumSquares(v + i, n - i);
+}
+
+__attribute__((target("sse4.1"))) void scale(double* v, std::size_t n, double factor)
+{
+    __m128d f = _mm_set1_pd(factor);
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd(v + i, _mm_mul_pd(_mm_loadu_pd(v + i), f));
+    scalar::scale(v + i, n - i, factor);
+}
+
+__attribute__((target("sse4.1"))) void rotate(double* x, double* y, std::size_t n, double cosT, double sinT)
+{
+    __m128d c = _mm_set1_pd(cosT), s = _mm_set1_pd(sinT);
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2)
+    {
+        __m128d xi = _mm_loadu_pd(x + i), yi = _mm_loadu_pd(y + i);
+        _mm_storeu_pd(x + i, _mm_sub_pd(_mm_mul_pd(c, xi), _mm_mul_pd(s, yi)));
+        _mm_storeu_pd(y + i, _mm_add_pd(_mm_mul_pd(s, xi), _mm_mul_pd(c, yi)));
+    }
+    scalar::rotate(x + i, y + i, n - i, cosT, sinT);
+}
+
+constexpr Kernels kernels{"SSE4.1", &sum, &sumSquares, &scale, &rotate};
+} // namespace sse4
+
+namespace avx2
+{
+__attribute__((target("avx2"))) double horizontalSum(__m256d v)
+{
+    __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(pair) + _mm_cvtsd_f64(_mm_unpackhi_pd(pair, pair));
+}
+
+__attribute__((target("avx2"))) double sum(const double* v, std::size_t n)
+{
+    __m256d a = _mm256_setzero_pd(), b = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        a = _mm256_add_pd(a, _mm256_loadu_pd(v + i));
+        b = _mm256_add_pd(b, _mm256_loadu_pd(v + i + 4));
+    }
+    return horizontalSum(_mm256_add_pd(a, b)) + scalar::sum(v + i, n - i);
+}
+
+__attribute__((target("avx2"))) double sumSquares(const double* v, std::size_t n)
+{
+    __m256d a = _mm256_setzero_pd(), b = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        __m256d x = _mm256_loadu_pd(v + i), y = _mm256_loadu_pd(v + i + 4);
+        a = _mm256_add_pd(a, _mm256_mul_pd(x, x));
+        b = _mm256_add_pd(b, _mm256_mul_pd(y, y));
+    }
+    return horizontalSum(_mm256_add_pd(a, b)) + scalar::sumSquares(v + i, n - i);
+}
+
+__attribute__((target("avx2"))) void scale(double* v, std::size_t n, double factor)
+{
+    __m256d f = _mm256_set1_pd(factor);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(v + i, _mm256_mul_pd(_mm256_loadu_pd(v + i), f));
+    scalar::scale(v + i, n - i, factor);
+}
+
+__attribute__((target("avx2"))) void rotate(double* x, double* y, std::size_t n, double cosT, double sinT)
+{
+    __m256d c = _mm256_set1_pd(cosT), s = _mm256_set1_pd(sinT);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d xi = _mm256_loadu_pd(x + i), yi = _mm256_loadu_pd(y + i);
+        _mm256_storeu_pd(x + i, _mm256_sub_pd(_mm256_mul_pd(c, xi), _mm256_mul_pd(s, yi)));
+        _mm256_storeu_pd(y + i, _mm256_add_pd(_mm256_mul_pd(s, xi), _mm256_mul_pd(c, yi)));
+    }
+    scalar::rotate(x + i, y + i, n - i, cosT, sinT);
+}
+
+constexpr Kernels kernels{"AVX2", &sum, &sumSquares, &scale, &rotate};
+} // namespace avx2
+#endif
+
+// Kernel sets this CPU can run, best first
+std::vector<const Kernels*> supportedKernels()
+{
+    std::vector<const Kernels*> result;
+#ifdef SHAPE_BATCH_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        result.push_back(&avx2::kernels);
+    if (__builtin_cpu_supports("sse4.1"))
+        result.push_back(&sse4::kernels);
+#endif
+    result.push_back(&scalar::kernels);
+    return result;
+}
+
+const Kernels& bestKernels()
+{
+    static const Kernels* best = supportedKernels().front();
+    return *best;
+}
+
+class ShapeBatch
+{
+public:
+    explicit ShapeBatch(const Kernels& kernels = bestKernels()) : _kernels{&kernels} {}
+
+    void add(Circle const& c, double x = 0, double y = 0)
+    {
+        _circleX.push_back(x);
+        _circleY.push_back(y);
+        _radius.push_back(c.radius());
+    }
+
+    void add(Square const& s, double x = 0, double y = 0)
+    {
+        _squareX.push_back(x);
+        _squareY.push_back(y);
+        _side.push_back(s.side());
+        _cos.push_back(1.0);
+        _sin.push_back(0.0);
+    }
+
+    std::size_t circleCount() const { return _radius.size(); }
+    std::size_t squareCount() const { return _side.size(); }
+
+    // Select the kernels explicitly (e.g. to compare instruction sets)
+    void useKernels(const Kernels& kernels) { _kernels = &kernels; }
+    const Kernels& kernels() const { return *_kernels; }
+
+private:
+    friend struct Draw;
+    friend struct Rotate;
+    friend struct Scale;
+    friend struct Area;
+    friend struct Perimeter;
+
+    const Kernels* _kernels;
+    std::vector<double> _circleX, _circleY, _radius;            // Circles
+    std::vector<double> _squareX, _squareY, _side, _cos, _sin;  // Squares, orientation as cos/sin
+};
+
+// Visitors over a whole batch
+struct Draw
+{
+    void operator()(ShapeBatch const& b) const
+    {
+        for (std::size_t i = 0; i < b.circleCount(); ++i)
+            std::cout << "Drawing Circle with radius " << b._radius[i] << " at (" << b._circleX[i] << ", "
+                      << b._circleY[i] << ")" << std::endl;
+        for (std::size_t i = 0; i < b.squareCount(); ++i)
+            std::cout << "Drawing Square with side " << b._side[i] << " at (" << b._squareX[i] << ", "
+                      << b._squareY[i] << "), angle " << std::atan2(b._sin[i], b._cos[i]) << std::endl;
+    }
+};
+
+// Rotation about the origin by `angle` radians
+struct Rotate
+{
+    double angle;
+
+    void operator()(ShapeBatch& b) const
+    {
+        const double c = std::cos(angle), s = std::sin(angle);
+        b._kernels->rotate(b._circleX.data(), b._circleY.data(), b.circleCount(), c, s);
+        b._kernels->rotate(b._squareX.data(), b._squareY.data(), b.squareCount(), c, s);
+        b._kernels->rotate(b._cos.data(), b._sin.data(), b.squareCount(), c, s);
+    }
+};
+
+// Scaling about the origin by `factor`
+struct Scale
+{
+    double factor;
+
+    void operator()(ShapeBatch& b) const
+    {
+        for (auto* v : {&b._circleX, &b._circleY, &b._radius, &b._squareX, &b._squareY, &b._side})
+            b._kernels->scale(v->data(), v->size(), factor);
+    }
+};
+
+// Total area
+struct Area
+{
+    double operator()(ShapeBatch const& b) const
+    {
+        return 3.141592653589793 * b._kernels->sumSquares(b._radius.data(), b.circleCount()) +
+               b._kernels->sumSquares(b._side.data(), b.squareCount());
+    }
+};
+
+// Total perimeter
+struct Perimeter
+{
+    double operator()(ShapeBatch const& b) const
+    {
+        return 2 * 3.141592653589793 * b._kernels->sum(b._radius.data(), b.circleCount()) +
+               4 * b._kernels->sum(b._side.data(), b.squareCount());
+    }
+};
+
+// Applies a visitor to a batch, like std::visit applies one to a shape
+template <typename Visitor, typename Batch>
+decltype(auto) visit(Visitor&& v, Batch&& batch)
+{
+    return std::forward<Visitor>(v)(std::forward<Batch>(batch));
+}
+
+int main(int argc, char* argv[])
+{
+    // A few shapes, drawn after rotating and scaling them
+    ShapeBatch small;
+    small.add(Circle{2.0}, 1.0, 0.0);
+    small.add(Square{1.5}, 0.0, 2.0);
+    small.add(Circle{4.2}, -3.0, 1.0);
+    visit(Rotate{3.141592653589793 / 2}, small);
+    visit(Scale{2.0}, small);
+    visit(Draw{}, small);
+    std::cout << "Area " << visit(Area{}, small) << ", perimeter " << visit(Perimeter{}, small)
+              << " (kernels: " << small.kernels().name << ")" << std::endl;
+
+    // Throughput of every kernel set this CPU supports
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    ShapeBatch batch;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        double position = static_cast<double>(i % 1000);
+        if (i % 2 == 0)
+            batch.add(Circle{1.0 + static_cast<double>(i % 7)}, position, -position);
+        else
+            batch.add(Square{1.0 + static_cast<double>(i % 5)}, -position, position);
+    }
+
+    for (const Kernels* kernels : supportedKernels())
+    {
+        batch.useKernels(*kernels);
+        auto start = std::chrono::steady_clock::now();
+        double area = visit(Area{}, batch);
+        double perimeter = visit(Perimeter{}, batch);
+        visit(Rotate{0.001}, batch);
+        visit(Scale{1.0}, batch); // Same memory traffic, keeps the results comparable
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << kernels->name << ": " << seconds * 1e9 / count << " ns/shape for area + perimeter + rotate + scale"
+                  << " (area " << area << ", perimeter " << perimeter << ")" << std::endl;
+    }
+
+    return 0;
+}
@@ -1,5 +1,9 @@
+#include <cstdint>
 #include <iostream>
 #include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 #include <variant>
 
@@ -77,6 +81,175 @@ void drawAllShapes(std::vector<Shape> const& shapes)
     }
 }
 
+// Type-partitioned collection (a "poly_collection")
+// Each alternative lives in its own contiguous vector instead of a vector of variants:
+// elements are not padded to the largest alternative, and for_each runs one tight loop per
+// type instead of a std::visit switch per element. Removal moves the last element of that
+// type into the hole; Handles stay valid across such moves because they go through a
+// per-type slot table, and a generation count makes handles to removed elements harmless.
+template <typename... Ts>
+class PolyCollection
+{
+public:
+    struct Handle
+    {
+        std::uint32_t type;       // Index of the alternative in Ts...
+        std::uint32_t slot;       // Slot in that alternative's table
+        std::uint32_t generation; // Generation of the slot when the handle was issued
+    };
+
+    template <typename T>
+    Handle insert(T shape)
+    {
+        return std::get<indexOf<T>()>(_stores).insert(std::move(shape), indexOf<T>());
+    }
+
+    // Removes the element; false if the handle is stale
+    bool erase(Handle h)
+    {
+        return eraseAt(h, std::index_sequence_for<Ts...>{});
+    }
+
+    // The element, or nullptr if the handle is stale or refers to another type
+    template <typename T>
+    T* get(Handle h)
+    {
+        return h.type == indexOf<T>() ? std::get<indexOf<T>()>(_stores).get(h) : nullptr;
+    }
+
+    // Calls v(element) for every element, one alternative after the other
+    template <typename Visitor>
+    void for_each(Visitor&& v)
+    {
+        std::apply([&v](auto&... stores) { (stores.forEach(v), ...); }, _stores);
+    }
+
+    template <typename Visitor>
+    void for_each(Visitor&& v) const
+    {
+        std::apply([&v](auto const&... stores) { (stores.forEach(v), ...); }, _stores);
+    }
+
+    std::size_t size() const
+    {
+        return std::apply([](auto const&... stores) { return (stores.items.size() + ... + 0); }, _stores);
+    }
+
+private:
+    static constexpr std::uint32_t NoItem = ~0u;
+
+    template <typename T>
+    struct Store
+    {
+        std::vector<T> items;                   // Contiguous elements of this alternative
+        std::vector<std::uint32_t> slotOfItem;  // Item -> slot
+        std::vector<std::uint32_t> itemOfSlot;  // Slot -> item, NoItem when free
+        std::vector<std::uint32_t> generations; // Slot -> current generation
+        std::vector<std::uint32_t> freeSlots;   // Slots available for reuse
+
+        Handle insert(T item, std::size_t type)
+        {
+            std::uint32_t slot;
+            if (freeSlots.empty())
+            {
+                slot = static_cast<std::uint32_t>(itemOfSlot.size());
+                itemOfSlot.push_back(NoItem);
+                generations.push_back(0);
+            }
+            else
+            {
+                slot = freeSlots.back();
+                freeSlots.pop_back();
+            }
+            itemOfSlot[slot] = static_cast<std::uint32_t>(items.size());
+            items.push_back(std::move(item));
+            slotOfItem.push_back(slot);
+            return Handle{static_cast<std::uint32_t>(type), slot, generations[slot]};
+        }
+
+        bool valid(Handle h) const
+        {
+            return h.slot < itemOfSlot.size() && itemOfSlot[h.slot] != NoItem && generations[h.slot] == h.generation;
+        }
+
+        T* get(Handle h)
+        {
+            return valid(h) ? &items[itemOfSlot[h.slot]] : nullptr;
+        }
+
+        bool erase(Handle h)
+        {
+            if (!valid(h))
+            {
+                return false;
+            }
+            std::uint32_t item = itemOfSlot[h.slot];
+            std::uint32_t last = static_cast<std::uint32_t>(items.size() - 1);
+            if (item != last)
+            {
+                items[item] = std::move(items[last]);
+                slotOfItem[item] = slotOfItem[last];
+                itemOfSlot[slotOfItem[item]] = item;
+            }
+            items.pop_back();
+            slotOfItem.pop_back();
+            itemOfSlot[h.slot] = NoItem;
+            ++generations[h.slot];
+            freeSlots.push_back(h.slot);
+            return true;
+        }
+
+        template <typename Visitor>
+        void forEach(Visitor& v)
+        {
+            for (auto& item : items)
+            {
+                v(item);
+            }
+        }
+
+        template <typename Visitor>
+        void forEach(Visitor& v) const
+        {
+            for (auto const& item : items)
+            {
+                v(item);
+            }
+        }
+    };
+
+    template <typename T>
+    static constexpr std::size_t indexOf()
+    {
+        constexpr bool matches[] = {std::is_same_v<T, Ts>...};
+        for (std::size_t i = 0; i < sizeof...(Ts); ++i)
+        {
+            if (matches[i])
+            {
+                return i;
+            }
+        }
+        return sizeof...(Ts);
+    }
+
+    template <std::size_t... Is>
+    bool eraseAt(Handle h, std::index_sequence<Is...>)
+    {
+        return ((h.type == Is && std::get<Is>(_stores).erase(h)) || ...);
+    }
+
+    std::tuple<Store<Ts>...> _stores;
+};
+
+// The same shapes as Shape, stored per alternative
+using ShapeCollection = PolyCollection<Circle, Square>;
+
+// Function to draw all shapes in a collection, type by type
+void drawAllShapes(ShapeCollection const& shapes)
+{
+    shapes.for_each(Draw{});
+}
+
 int main()
 {
     // Creating some shapes
@@ -94,5 +267,16 @@ int main()
         std::visit(Rotate{}, s);
     }
 
+    // The same shapes in a type-partitioned collection
+    ShapeCollection collection;
+    collection.insert(Circle{2.0});
+    auto square = collection.insert(Square{1.5});
+    collection.insert(Circle{4.2});
+    drawAllShapes(collection);
+
+    // Handles survive other elements moving; removed elements are gone
+    collection.erase(square);
+    collection.for_each(Rotate{});
+
     return 0;
 }
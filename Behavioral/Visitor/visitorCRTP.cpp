@@ -1,5 +1,7 @@
+#include <cstdint>
 #include <iostream>
-#include <memory>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
 // Visitor Interface (generic, not tied to CRTP)
@@ -10,6 +12,11 @@ public:
     void accept(Visitor&& v) {
         v.visit(static_cast<Derived&>(*this)); // Static dispatch via CRTP
     }
+
+    template <typename Visitor>
+    void accept(Visitor&& v) const {
+        v.visit(static_cast<Derived const&>(*this));
+    }
 };
 
 // Concrete shapes using CRTP
@@ -62,14 +69,93 @@ struct Rotate {
     }
 };
 
-// Function to draw all shapes (using type-erasure)
-void drawAllShapes(std::vector<std::unique_ptr<void, void(*)(void*)>> const& shapes) {
-    for (auto const& s : shapes) {
-        // Requires type-erasure to work (non-trivial here; omitted for brevity).
-        // Example: Assume we stored a function to dispatch the visitor.
+// Heterogeneous container for CRTP shapes
+// Shapes are kept by value in one vector per type, and the sequence itself is a list of
+// (type tag, index) pairs, so adding a shape never allocates it on its own. accept(v) looks
+// each tag up in a table generated at compile time for that visitor type (one entry per shape
+// type); every entry calls the statically dispatched ShapeCRTP::accept, so the table call is
+// the only indirection left per element. Any visitor with a visit overload per shape works.
+template <typename... Shapes>
+class ShapeList {
+    static_assert(sizeof...(Shapes) <= 256, "type tags are 8 bits");
+
+public:
+    template <typename T>
+    void push_back(T shape) {
+        auto& store = std::get<std::vector<T>>(_stores);
+        _entries.push_back(Entry{tagOf<T>(), static_cast<std::uint32_t>(store.size())});
+        store.push_back(std::move(shape));
+    }
+
+    // Visits every shape, in insertion order
+    template <typename Visitor>
+    void accept(Visitor&& v) {
+        using V = std::remove_reference_t<Visitor>;
+        for (Entry e : _entries) {
+            table<V>[e.tag](*this, e.index, v);
+        }
+    }
+
+    template <typename Visitor>
+    void accept(Visitor&& v) const {
+        using V = std::remove_reference_t<Visitor>;
+        for (Entry e : _entries) {
+            constTable<V>[e.tag](*this, e.index, v);
+        }
+    }
+
+    std::size_t size() const { return _entries.size(); }
+
+private:
+    struct Entry {
+        std::uint8_t tag;     // Index of the shape type in Shapes...
+        std::uint32_t index;  // Position in that type's vector
+    };
+
+    template <typename T>
+    static constexpr std::uint8_t tagOf() {
+        constexpr bool matches[] = {std::is_same_v<T, Shapes>...};
+        for (std::size_t i = 0; i < sizeof...(Shapes); ++i) {
+            if (matches[i]) {
+                return static_cast<std::uint8_t>(i);
+            }
+        }
+        return 0;
+    }
+
+    template <typename T, typename Visitor>
+    static void visitOne(ShapeList& list, std::uint32_t index, Visitor& v) {
+        std::get<std::vector<T>>(list._stores)[index].accept(v);
+    }
+
+    template <typename T, typename Visitor>
+    static void visitOneConst(ShapeList const& list, std::uint32_t index, Visitor& v) {
+        std::get<std::vector<T>>(list._stores)[index].accept(v);
     }
+
+    // Dispatch tables, indexed by tag
+    template <typename Visitor>
+    static constexpr void (*table[])(ShapeList&, std::uint32_t, Visitor&) = {&visitOne<Shapes, Visitor>...};
+
+    template <typename Visitor>
+    static constexpr void (*constTable[])(ShapeList const&, std::uint32_t, Visitor&) = {&visitOneConst<Shapes, Visitor>...};
+
+    std::tuple<std::vector<Shapes>...> _stores;
+    std::vector<Entry> _entries;
+};
+
+// Function to draw all shapes (type-erased through the tag-indexed dispatch table)
+void drawAllShapes(ShapeList<Circle, Square> const& shapes) {
+    shapes.accept(Draw{});
 }
 
+// A user-defined visitor works the same way
+struct TotalArea {
+    void visit(Circle const& c) { total += 3.141592653589793 * c.radius() * c.radius(); }
+    void visit(Square const& s) { total += s.side() * s.side(); }
+    double total = 0;
+};
+
 int main() {
     // Example usage (simplified without type-erasure):
     Circle c{2.0};
@@ -77,6 +163,19 @@ int main() {
 
     c.accept(Draw{}); // Output: Drawing Circle with radius 2
     s.accept(Rotate{}); // Output: Rotating Square with side 1.5
+
+    // Mixed shapes in one container
+    ShapeList<Circle, Square> shapes;
+    shapes.push_back(Circle{2.0});
+    shapes.push_back(Square{1.5});
+    shapes.push_back(Circle{4.2});
+
+    drawAllShapes(shapes);
+    shapes.accept(Rotate{});
+
+    TotalArea area;
+    shapes.accept(area);
+    std::cout << "Total area: " << area.total << std::endl;
     
     return 0;
 }
@@ -1,4 +1,11 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
 #include <iostream>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 /*
@@ -53,7 +60,7 @@ public:
     void Enter() override {} // Implementation of interface method
 
 private:
-    MapSite* _sides[4] = {}; // Array to hold room's sides (4 directions)
+    MapSite* _sides[4] = {}; // Room's sides (4 directions); non-owning, walls may be shared flyweights
     int _roomNumber;         // Room identifier
 };
 
@@ -82,10 +89,95 @@ public:
     void Enter() override {} // Implementation of interface method
 };
 
+// Flyweight: one shared, stateless instance per wall kind (see Builder.cpp)
+class WallFlyweights {
+public:
+    template <class TWall = Wall>
+    static TWall* Get() {
+        static TWall instance; // Constructed once, on first use (thread-safe since C++11)
+        return &instance;
+    }
+};
+
+/*
+    Arena (bump allocator) used by ArenaMazeFactory.
+
+    Objects are carved out of large contiguous blocks by bumping an offset, so creating a
+    MapSite costs a pointer increment instead of a call to malloc, and the rooms and doors of
+    one maze end up next to each other in memory (walls are the shared flyweights above and
+    never come from an arena). Nothing is freed individually: the whole arena (and every
+    object in it) is released at once when it is destroyed.
+*/
+class Arena {
+public:
+    explicit Arena(std::size_t blockSize = 64 * 1024) : _blockSize(blockSize) {}
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    ~Arena() {
+        if (_binding && *_binding == this) {
+            *_binding = nullptr; // The factory still allocating into this arena stops here
+        }
+        // Destroy objects in reverse order of construction; the blocks are released afterwards
+        for (Destructor* d = _destructors; d; d = d->next) {
+            d->destroy(d->object);
+        }
+    }
+
+    // Pointer cleared when the arena is destroyed (nullptr: none); set by the allocating factory
+    void Bind(Arena** binding) { _binding = binding; }
+
+    // Construct a T inside the arena
+    template <class T, class... Args>
+    T* Make(Args&&... args) {
+        void* memory = Allocate(sizeof(T), alignof(T));
+        T* object = new (memory) T(std::forward<Args>(args)...);
+        if (!std::is_trivially_destructible<T>::value) {
+            // The record lives in the arena too, so tracking destructors never allocates
+            void* record = Allocate(sizeof(Destructor), alignof(Destructor));
+            _destructors = new (record) Destructor{object, [](void* p) { static_cast<T*>(p)->~T(); }, _destructors};
+        }
+        return object;
+    }
+
+private:
+    // Intrusive list node, newest first
+    struct Destructor {
+        void* object;
+        void (*destroy)(void*);
+        Destructor* next;
+    };
+
+    void* Allocate(std::size_t size, std::size_t alignment) {
+        void* current = _current;
+        if (!_current || !std::align(alignment, size, current, _remaining)) {
+            // Current block exhausted: start a new one (oversized requests get their own block)
+            std::size_t blockSize = std::max(_blockSize, size + alignment);
+            _blocks.emplace_back(new std::byte[blockSize]);
+            current = _blocks.back().get();
+            _remaining = blockSize;
+            std::align(alignment, size, current, _remaining);
+        }
+        _current = static_cast<std::byte*>(current) + size;
+        _remaining -= size;
+        return current;
+    }
+
+    std::size_t _blockSize;                            // Size of each block requested from the heap
+    std::vector<std::unique_ptr<std::byte[]>> _blocks; // Blocks owned by the arena
+    void* _current = nullptr;                          // Bump pointer inside the last block
+    std::size_t _remaining = 0;                        // Bytes left in the last block
+    Destructor* _destructors = nullptr;                // Non-trivial objects to destroy on release
+    Arena** _binding = nullptr;                        // Factory's pointer to this arena, if bound
+};
+
 // Complex Product: Maze containing multiple rooms
 class Maze {
 public:
     Maze() = default;
+
+    // Maze that owns the arena its components were allocated from
+    explicit Maze(std::unique_ptr<Arena> arena) : _arena(std::move(arena)) {}
     
     // Add a room to the maze
     void AddRoom(Room* room) { _rooms.push_back(room); }
@@ -93,8 +185,12 @@ public:
     // Get a room by number
     Room* RoomNo(int roomNumber) const { return _rooms[roomNumber]; }
 
+    // Arena backing this maze's components (nullptr for heap-allocated mazes)
+    Arena* GetArena() const { return _arena.get(); }
+
 private:
-    std::vector<Room*> _rooms; // Collection of rooms in the maze
+    std::vector<Room*> _rooms;     // Collection of rooms in the maze
+    std::unique_ptr<Arena> _arena; // Frees every arena-allocated room and door with the maze
 };
 
 /*
@@ -108,15 +204,66 @@ public:
     // Factory methods for creating maze components
     virtual Maze* MakeMaze() const { return new Maze; }
     virtual Room* MakeRoom(int n) const { return new Room(n); }
-    virtual Wall* MakeWall() const { return new Wall; }
+    virtual Wall* MakeWall() const { return WallFlyweights::Get<Wall>(); } // Shared, never deleted
     virtual Door* MakeDoor(Room* r1, Room* r2) const { return new Door(r1, r2); }
 };
 
 /*
-    Client Code: Creates a maze using components from the provided factory
-    This implementation is factory-agnostic - it works with any MazeFactory implementation
+    Concrete Factory: Allocates every component of a maze from one Arena.
+
+    MakeMaze creates a fresh arena and hands its ownership to the new Maze; the following
+    MakeRoom/MakeDoor calls allocate from that arena (walls are the shared flyweights), so
+    deleting the Maze releases the whole object graph in one shot. MakeMaze must therefore
+    be called first, which is exactly what CreateMaze does. The factory keeps a plain pointer
+    to that arena, bound once per MakeMaze, so a component costs no more than the bump
+    allocation. The arena clears that pointer when its Maze is deleted; further components
+    then fall back to plain heap allocation instead of writing into freed blocks.
 */
-Maze* CreateMaze(MazeFactory& factory) {
+class ArenaMazeFactory final : public MazeFactory {
+public:
+    explicit ArenaMazeFactory(std::size_t blockSize = 64 * 1024) : _blockSize(blockSize) {}
+    ArenaMazeFactory(const ArenaMazeFactory&) = delete;
+    ArenaMazeFactory& operator=(const ArenaMazeFactory&) = delete;
+
+    ~ArenaMazeFactory() override {
+        if (_arena) {
+            _arena->Bind(nullptr); // The maze outlives the factory
+        }
+    }
+
+    Maze* MakeMaze() const override {
+        if (_arena) {
+            _arena->Bind(nullptr); // The previous maze no longer needs to tell us
+        }
+        auto arena = std::make_unique<Arena>(_blockSize);
+        _arena = arena.get();
+        _arena->Bind(&_arena);
+        return new Maze(std::move(arena));
+    }
+
+    Room* MakeRoom(int n) const override { return _arena ? _arena->Make<Room>(n) : MazeFactory::MakeRoom(n); }
+    Door* MakeDoor(Room* r1, Room* r2) const override {
+        return _arena ? _arena->Make<Door>(r1, r2) : MazeFactory::MakeDoor(r1, r2);
+    }
+
+private:
+    std::size_t _blockSize;
+    mutable Arena* _arena = nullptr; // Arena of the maze being built (owned by that Maze); cleared with it
+};
+
+/*
+    Client Code: Creates a maze using components from the provided factory.
+
+    The layout is written once, with the factory type as a template parameter (a compile-time
+    policy). Overload resolution picks the entry point: a factory passed as MazeFactory&
+    (selected at run time) takes the non-template overload below, which instantiates this
+    template with MazeFactory and dispatches every Make* call virtually, while a concrete
+    factory object picks the template directly. When that factory class is final, the compiler
+    knows the exact type behind every MakeRoom/MakeWall/MakeDoor call, binds them statically
+    and can inline them.
+*/
+template <class Factory>
+Maze* CreateMaze(Factory& factory) {
     // Create maze using factory methods
     Maze* aMaze = factory.MakeMaze();
     Room* r1 = factory.MakeRoom(1);
@@ -142,6 +289,49 @@ Maze* CreateMaze(MazeFactory& factory) {
     return aMaze;
 }
 
+// Factory-agnostic entry point: works with any MazeFactory implementation
+Maze* CreateMaze(MazeFactory& factory) {
+    return CreateMaze<MazeFactory>(factory);
+}
+
+// Builds a corridor of `roomCount` rooms joined east-west by doors. Instantiated with
+// MazeFactory it dispatches virtually; with a final concrete factory, statically.
+template <class Factory>
+Maze* CreateCorridorMaze(Factory& factory, int roomCount) {
+    Maze* aMaze = factory.MakeMaze();
+    Room* previous = nullptr;
+    for (int n = 0; n < roomCount; ++n) {
+        Room* room = factory.MakeRoom(n);
+        aMaze->AddRoom(room);
+        room->SetSide(North, factory.MakeWall());
+        room->SetSide(South, factory.MakeWall());
+        room->SetSide(East, factory.MakeWall());
+        if (previous) {
+            Door* door = factory.MakeDoor(previous, room);
+            previous->SetSide(East, door);
+            room->SetSide(West, door);
+        } else {
+            room->SetSide(West, factory.MakeWall());
+        }
+        previous = room;
+    }
+    return aMaze;
+}
+
+// Benchmark helper: best of `runs` builds, in milliseconds
+template <class Build>
+double BestBuildMilliseconds(Build build, int runs) {
+    double best = 0;
+    for (int run = 0; run < runs; ++run) {
+        auto start = std::chrono::steady_clock::now();
+        Maze* maze = build();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        delete maze;
+        best = (run == 0 || elapsed.count() < best) ? elapsed.count() : best;
+    }
+    return best;
+}
+
 int main() {
     /*
         Usage Example:
@@ -153,6 +343,19 @@ int main() {
         EnchantedMazeFactory enchantedFactory;
         Maze* fairyMaze = CreateMaze(enchantedFactory);
     */
+
+    // Arena-backed maze: all rooms, walls and doors are freed together with the maze
+    ArenaMazeFactory arenaFactory;
+    Maze* arenaMaze = CreateMaze(arenaFactory);
+    delete arenaMaze;
+
+    // Virtual vs. static dispatch on a 1M-room build (arena-backed, so malloc does not dominate)
+    const int roomCount = 1000000;
+    MazeFactory& runtimeFactory = arenaFactory; // Factory type only known at run time
+    std::cout << "1M rooms, virtual dispatch: "
+              << BestBuildMilliseconds([&] { return CreateCorridorMaze<MazeFactory>(runtimeFactory, roomCount); }, 5) << " ms" << std::endl;
+    std::cout << "1M rooms, static dispatch:  "
+              << BestBuildMilliseconds([&] { return CreateCorridorMaze(arenaFactory, roomCount); }, 5) << " ms" << std::endl;
     
     return 0;
 }
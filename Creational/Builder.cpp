@@ -1,4 +1,10 @@
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 /* Ignore the Below code from previous Abstract Factory */
@@ -34,7 +40,7 @@ public:
     void Enter() override {} // Implementation of interface method
 
 private:
-    MapSite* _sides[4] = {}; // Array to hold room's sides (4 directions)
+    MapSite* _sides[4] = {}; // Room's sides (4 directions); non-owning, walls may be shared flyweights
     int _roomNumber;         // Room identifier
 };
 
@@ -63,19 +69,220 @@ public:
     void Enter() override {} // Implementation of interface method
 };
 
+/*
+    Flyweight: Walls carry no intrinsic state, so a single shared instance per wall kind can
+    stand in for every wall side of every room. Rooms only point at these instances (their
+    sides are non-owning) and must never delete them; they live until program exit.
+*/
+class WallFlyweights {
+public:
+    template <class TWall = Wall>
+    static TWall* Get() {
+        static TWall instance; // Constructed once, on first use (thread-safe since C++11)
+        return &instance;
+    }
+};
+
+/*
+    RoomIndex : O(1) lookup from room number to Room, for any numbering.
+
+    While the numbers seen so far are reasonably contiguous the index is a flat table indexed
+    by (number - base). As soon as a new number would leave the table less than a quarter
+    full, the index switches for good to an open-addressing hash table (linear probing, load
+    factor at most 1/2), so sparse numbering from sharded generators costs O(rooms) memory.
+*/
+class RoomIndex {
+public:
+    // Room with the given number, or nullptr if there is none
+    Room* Find(int number) const {
+        if (_dense) {
+            long long slot = static_cast<long long>(number) - _base;
+            return (slot < 0 || slot >= static_cast<long long>(_table.size())) ? nullptr : _table[slot];
+        }
+        for (std::size_t i = Hash(number); ; i = (i + 1) & (_slots.size() - 1)) {
+            const Slot& slot = _slots[i];
+            if (!slot.room || slot.number == number) {
+                return slot.room;
+            }
+        }
+    }
+
+    // Make room for `count` more rooms, assuming they continue the current numbering
+    void Reserve(std::size_t count) {
+        if (_dense) {
+            _table.reserve(_table.size() + count);
+        } else if (2 * (_size + count) > _slots.size()) {
+            std::size_t slotCount = _slots.size();
+            while (2 * (_size + count) > slotCount) {
+                slotCount *= 2;
+            }
+            Rehash(slotCount);
+        }
+    }
+
+    // Index a room; a later room with the same number replaces the earlier one
+    void Insert(int number, Room* room) {
+        if (_dense && !InsertDense(number, room)) {
+            ConvertToHash();
+        }
+        if (!_dense) {
+            InsertHash(number, room);
+        }
+    }
+
+    // Index `count` rooms at once. Their numbers must be distinct, not indexed yet, and within
+    // [low, high]; the density check and the table growth then happen once for the batch.
+    void InsertDistinct(const int* numbers, Room* const* rooms, std::size_t count, int low, int high) {
+        if (count == 0) {
+            return;
+        }
+        if (_dense) {
+            if (_size == 0) {
+                _base = _low = _high = low;
+            }
+            long long newLow = std::min<long long>(_low, low);
+            long long newHigh = std::max<long long>(_high, high);
+            if (static_cast<std::size_t>(newHigh - newLow + 1) <= std::max(MinDenseSpan, 4 * (_size + count))) {
+                CoverDense(newLow, newHigh);
+                for (std::size_t i = 0; i < count; ++i) {
+                    _table[static_cast<std::size_t>(numbers[i] - _base)] = rooms[i];
+                }
+                _size += count;
+                return;
+            }
+            ConvertToHash();
+        }
+        Reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            InsertHash(numbers[i], rooms[i]);
+        }
+    }
+
+private:
+    static constexpr std::size_t MinDenseSpan = 64; // Small tables stay flat regardless of density
+
+    struct Slot {
+        int number = 0;
+        Room* room = nullptr; // nullptr marks an empty slot
+    };
+
+    bool InsertDense(int number, Room* room) {
+        if (_size == 0) {
+            _base = _low = _high = number;
+        }
+        long long low = std::min<long long>(_low, number);
+        long long high = std::max<long long>(_high, number);
+        std::size_t span = static_cast<std::size_t>(high - low + 1);
+        if (span > std::max(MinDenseSpan, 4 * (_size + 1))) {
+            return false; // Too sparse for a flat table
+        }
+        CoverDense(low, high);
+        Room*& entry = _table[static_cast<std::size_t>(number - _base)];
+        _size += entry ? 0 : 1;
+        entry = room;
+        return true;
+    }
+
+    // Grow the flat table to cover the numbers [low, high], the new range of indexed rooms
+    void CoverDense(long long low, long long high) {
+        if (low < _base) {
+            // Grow towards smaller numbers by at least the table's size, so descending numbering
+            // shifts the entries O(log n) times instead of once per room
+            long long grow = std::max<long long>(_base - low, static_cast<long long>(_table.size()));
+            long long base = std::max<long long>(std::numeric_limits<int>::min(), _base - grow);
+            _table.insert(_table.begin(), static_cast<std::size_t>(_base - base), nullptr);
+            _base = base;
+        }
+        if (high - _base >= static_cast<long long>(_table.size())) {
+            _table.resize(static_cast<std::size_t>(high - _base + 1), nullptr); // Amortized by vector growth
+        }
+        _low = low;
+        _high = high;
+    }
+
+    void ConvertToHash() {
+        std::vector<Room*> table = std::move(_table);
+        _table.clear();
+        _dense = false;
+        _size = 0;
+        _slots.assign(16, Slot{});
+        for (std::size_t i = 0; i < table.size(); ++i) {
+            if (table[i]) {
+                InsertHash(static_cast<int>(_base + static_cast<long long>(i)), table[i]);
+            }
+        }
+    }
+
+    void Rehash(std::size_t slotCount) {
+        std::vector<Slot> old = std::move(_slots);
+        _slots.assign(slotCount, Slot{});
+        _size = 0;
+        for (const Slot& slot : old) {
+            if (slot.room) {
+                InsertHash(slot.number, slot.room);
+            }
+        }
+    }
+
+    void InsertHash(int number, Room* room) {
+        if (2 * (_size + 1) > _slots.size()) {
+            Rehash(_slots.size() * 2);
+        }
+        for (std::size_t i = Hash(number); ; i = (i + 1) & (_slots.size() - 1)) {
+            Slot& slot = _slots[i];
+            if (!slot.room || slot.number == number) {
+                _size += slot.room ? 0 : 1;
+                slot = Slot{number, room};
+                return;
+            }
+        }
+    }
+
+    std::size_t Hash(int number) const {
+        // Fibonacci hashing spreads consecutive and strided numbers over the table
+        std::uint64_t h = static_cast<std::uint32_t>(number) * 0x9E3779B97F4A7C15ull;
+        return static_cast<std::size_t>(h >> 32) & (_slots.size() - 1);
+    }
+
+    bool _dense = true;        // Flat table while the numbering is contiguous enough
+    long long _base = 0;       // Room number stored in _table[0] (may lie below _low: front slack)
+    long long _low = 0;        // Dense mode: smallest room number indexed
+    long long _high = 0;       // Dense mode: largest room number indexed
+    std::vector<Room*> _table; // Dense mode: rooms by (number - _base)
+    std::vector<Slot> _slots;  // Hash mode: power-of-two open-addressing table
+    std::size_t _size = 0;     // Number of indexed rooms
+};
+
 // Product: Represents the complex object under construction
 class Maze {
 public:
     Maze() = default;
     
     // Add a room to the maze
-    void AddRoom(Room* room) { _rooms.push_back(room); }
+    void AddRoom(Room* room) {
+        _rooms.push_back(room);
+        _index.Insert(room->GetRoomNumber(), room);
+    }
+
+    // Pre-allocate space for `roomCount` more rooms, in the room list and the index
+    void Reserve(std::size_t roomCount) {
+        _rooms.reserve(_rooms.size() + roomCount);
+        _index.Reserve(roomCount);
+    }
+
+    // Add `count` rooms at once; numbers[i] is the number of rooms[i]. The numbers must be
+    // distinct, new to this maze, and within [low, high] (see RoomIndex::InsertDistinct).
+    void AddRooms(const int* numbers, Room* const* rooms, std::size_t count, int low, int high) {
+        _rooms.insert(_rooms.end(), rooms, rooms + count);
+        _index.InsertDistinct(numbers, rooms, count, low, high);
+    }
     
-    // Get a room by number
-    Room* RoomNo(int roomNumber) const { return _rooms[roomNumber]; }
+    // Get a room by number (nullptr if the maze has no such room)
+    Room* RoomNo(int roomNumber) const { return _index.Find(roomNumber); }
 
 private:
-    std::vector<Room*> _rooms; // Collection of rooms in the maze
+    std::vector<Room*> _rooms; // Collection of rooms in the maze, in insertion order
+    RoomIndex _index;          // Room number -> room, for any numbering
 };
 
 /*
@@ -113,10 +320,25 @@ private:
 class MazeBuilder 
 {
 public:
+    using DoorPair = std::pair<int, int>; // (roomFrom, roomTo)
+
     virtual void BuildMaze() { }
     virtual void BuildRoom(int room) { }
     virtual void BuildDoor(int roomFrom, int roomTo) { }
     virtual Maze* GetMaze() { return nullptr; }
+
+    // Batch steps: one virtual call for a whole range. The defaults fall back to the single
+    // steps; concrete builders override them to reserve storage and skip per-call overhead.
+    virtual void BuildRooms(const int* rooms, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            BuildRoom(rooms[i]);
+        }
+    }
+    virtual void BuildDoors(const DoorPair* doors, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            BuildDoor(doors[i].first, doors[i].second);
+        }
+    }
     virtual ~MazeBuilder() = default; // Virtual destructor for polymorphic deletion
 
 protected:
@@ -133,43 +355,291 @@ public:
     }
     
     void BuildRoom(int room) override {
-        if (!_currentMaze->RoomNo(room)) {
-            Room* newRoom = new Room(room);
-            _currentMaze->AddRoom(newRoom);
-            // Initialize all sides with walls
-            newRoom->SetSide(North, new Wall());
-            newRoom->SetSide(South, new Wall());
-            newRoom->SetSide(East, new Wall());
-            newRoom->SetSide(West, new Wall());
-        }
+        AddRoom(room, WallFlyweights::Get<Wall>());
     }
     
     void BuildDoor(int roomFrom, int roomTo) override {
-        Room* r1 = _currentMaze->RoomNo(roomFrom);
-        Room* r2 = _currentMaze->RoomNo(roomTo);
-        Door* door = new Door(r1, r2);
-        
-        // Determine common wall direction and set the door
-        Direction r1Side = CommonWall(r1, r2);
-        Direction r2Side = CommonWall(r2, r1);
-        r1->SetSide(r1Side, door);
-        r2->SetSide(r2Side, door);
+        AddDoor(_currentMaze->RoomNo(roomFrom), _currentMaze->RoomNo(roomTo), CommonWall(roomFrom, roomTo));
+    }
+
+    void BuildRooms(const int* rooms, std::size_t count) override {
+        _currentMaze->Reserve(count); // One regrowth for the whole batch
+        Wall* wall = WallFlyweights::Get<Wall>();
+        for (std::size_t i = 0; i < count; ++i) {
+            AddRoom(rooms[i], wall);
+        }
+    }
+
+    void BuildDoors(const DoorPair* doors, std::size_t count) override {
+        // Directors emit doors grouped by room (a corridor chains n -> n+1, a grid fans out
+        // from n), so remembering the last two rooms resolved looks up each room about once
+        // per batch instead of twice per door
+        int cachedNumber[2] = {0, 0};
+        Room* cachedRoom[2] = {nullptr, nullptr};
+        int victim = 0;
+        auto resolve = [&](int number) {
+            for (int c = 0; c < 2; ++c) {
+                if (cachedRoom[c] && cachedNumber[c] == number) {
+                    return cachedRoom[c];
+                }
+            }
+            Room* room = _currentMaze->RoomNo(number);
+            cachedNumber[victim] = number;
+            cachedRoom[victim] = room;
+            victim ^= 1;
+            return room;
+        };
+        for (std::size_t i = 0; i < count; ++i) {
+            Room* r1 = resolve(doors[i].first);
+            Room* r2 = resolve(doors[i].second);
+            AddDoor(r1, r2, CommonWall(doors[i].first, doors[i].second));
+        }
     }
     
     Maze* GetMaze() override {
         return _currentMaze;
     }
 
-private:
+protected:
     // Determines the direction of the common wall between two rooms
-    Direction CommonWall(Room* r1, Room* r2) {
+    static Direction CommonWall(int room1, int room2) {
         // Simple heuristic: assumes rooms are ordered and adjacent east-west
-        return (r1->GetRoomNumber() < r2->GetRoomNumber()) ? East : West;
+        return (room1 < room2) ? East : West;
+    }
+    static Direction CommonWall(Room* r1, Room* r2) { return CommonWall(r1->GetRoomNumber(), r2->GetRoomNumber()); }
+
+    // The wall facing `side` from the room on the other side
+    static Direction Opposite(Direction side) {
+        switch (side) {
+        case North: return South;
+        case South: return North;
+        case East:  return West;
+        default:    return East;
+        }
+    }
+
+    // Creates a room with every side set to the shared wall
+    static Room* NewRoom(int room, Wall* wall) {
+        Room* newRoom = new Room(room);
+        newRoom->SetSide(North, wall);
+        newRoom->SetSide(South, wall);
+        newRoom->SetSide(East, wall);
+        newRoom->SetSide(West, wall);
+        return newRoom;
+    }
+
+    // Joins two rooms with a new door on their common wall (`r1Side`, as seen from r1)
+    static void Connect(Room* r1, Room* r2, Direction r1Side) {
+        Door* door = new Door(r1, r2);
+        r1->SetSide(r1Side, door);
+        r2->SetSide(Opposite(r1Side), door);
+    }
+    static void Connect(Room* r1, Room* r2) { Connect(r1, r2, CommonWall(r1, r2)); }
+
+private:
+    // Non-virtual step bodies shared by the single and batch entry points
+    void AddRoom(int room, Wall* wall) {
+        if (!_currentMaze->RoomNo(room)) {
+            _currentMaze->AddRoom(NewRoom(room, wall));
+        }
+    }
+
+    void AddDoor(Room* r1, Room* r2, Direction r1Side) {
+        if (!r1 || !r2) {
+            return; // Door to a room that was never built: skipped, as ParallelMazeBuilder does
+        }
+        Connect(r1, r2, r1Side);
     }
 
+protected:
+
     Maze* _currentMaze;
 };
 
+/*
+    ConcreteBuilder: Builds large mazes on several worker threads.
+
+    BuildRoom/BuildDoor only record the requested steps; the actual construction happens in
+    GetMaze, in four phases:
+
+    1. The recorded rooms are split into one contiguous range per worker, and every worker
+       builds its rooms (with their walls) into its own partition.
+    2. Every worker sorts its share of the recorded doors into per-partition buckets; a door
+       whose two rooms live in different partitions goes to that worker's "crossing" list.
+    3. Every worker connects the doors of its own partition. Only that worker touches those
+       rooms, so no locking is needed.
+    4. Merge: the partitions are appended to the maze in one bulk insert (the room index grows
+       once, to the batch's number range) and the crossing doors are stitched sequentially.
+
+    With a single worker (configured, or too few rooms to split) the partitions would only add
+    work, so the recorded steps are replayed through StandardMazeBuilder's batch steps instead.
+
+    Before phase 1 the recorded rooms are deduplicated sequentially, with the same rule as
+    StandardMazeBuilder: the first room with a given number wins, and numbers already in the
+    maze (from an earlier GetMaze) are skipped. A door may name rooms recorded in the same
+    batch or built by an earlier GetMaze. A door to a room that was never built is skipped.
+    Doors are applied in recording order within a partition, and crossing doors are applied
+    last.
+*/
+class ParallelMazeBuilder : public StandardMazeBuilder {
+public:
+    explicit ParallelMazeBuilder(unsigned workers = std::thread::hardware_concurrency())
+        : _workers(std::max(1u, workers)) {}
+
+    void BuildMaze() override {
+        StandardMazeBuilder::BuildMaze();
+        _rooms.clear();
+        _doors.clear();
+    }
+
+    void BuildRoom(int room) override { _rooms.push_back(room); }
+
+    void BuildDoor(int roomFrom, int roomTo) override { _doors.emplace_back(roomFrom, roomTo); }
+
+    void BuildRooms(const int* rooms, std::size_t count) override { _rooms.insert(_rooms.end(), rooms, rooms + count); }
+
+    void BuildDoors(const DoorPair* doors, std::size_t count) override { _doors.insert(_doors.end(), doors, doors + count); }
+
+    Maze* GetMaze() override {
+        if (!_rooms.empty() || !_doors.empty()) {
+            Build();
+        }
+        return _currentMaze;
+    }
+
+private:
+    using IndexPair = std::pair<std::size_t, std::size_t>; // Door endpoints as indices into _rooms
+    using RoomPair = std::pair<Room*, Room*>;               // Door endpoints resolved to rooms
+    static constexpr std::size_t NoRoom = static_cast<std::size_t>(-1);
+    static constexpr std::size_t MinRoomsPerWorker = 4096; // Below this a thread is not worth it
+
+    // Runs task(worker) on `count` threads and waits for all of them
+    template <class Task>
+    static void RunWorkers(unsigned count, Task task) {
+        std::vector<std::thread> threads;
+        threads.reserve(count - 1);
+        for (unsigned w = 1; w < count; ++w) {
+            threads.emplace_back(task, w);
+        }
+        task(0u);
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+
+    void Build() {
+        if (_workers == 1 || _rooms.size() < 2 * MinRoomsPerWorker) {
+            StandardMazeBuilder::BuildRooms(_rooms.data(), _rooms.size());
+            StandardMazeBuilder::BuildDoors(_doors.data(), _doors.size());
+            _rooms.clear();
+            _doors.clear();
+            return;
+        }
+
+        // Room number -> index into _rooms: a flat table when the numbers are dense enough
+        long long minNumber = 0;
+        long long maxNumber = 0;
+        std::size_t span = 0;
+        if (!_rooms.empty()) {
+            auto [minIt, maxIt] = std::minmax_element(_rooms.begin(), _rooms.end());
+            minNumber = *minIt;
+            maxNumber = *maxIt;
+            span = static_cast<std::size_t>(maxNumber - minNumber + 1);
+        }
+        const bool dense = span <= 4 * _rooms.size();
+        std::vector<std::size_t> denseIndex(dense ? span : 0, NoRoom);
+        std::unordered_map<int, std::size_t> sparseIndex;
+        if (!dense) {
+            sparseIndex.reserve(_rooms.size());
+        }
+
+        // Deduplicate before any thread starts, compacting _rooms to the rooms to build
+        std::size_t unique = 0;
+        for (std::size_t i = 0; i < _rooms.size(); ++i) {
+            const int number = _rooms[i];
+            if (_currentMaze->RoomNo(number)) {
+                continue;
+            }
+            std::size_t& slot = dense ? denseIndex[static_cast<std::size_t>(number - minNumber)]
+                                      : sparseIndex.emplace(number, NoRoom).first->second;
+            if (slot == NoRoom) {
+                slot = unique;
+                _rooms[unique++] = number;
+            }
+        }
+        _rooms.resize(unique);
+        auto indexOf = [&](int number) -> std::size_t {
+            if (dense) {
+                long long slot = number - minNumber;
+                return (slot < 0 || static_cast<std::size_t>(slot) >= span) ? NoRoom : denseIndex[slot];
+            }
+            auto it = sparseIndex.find(number);
+            return it == sparseIndex.end() ? NoRoom : it->second;
+        };
+
+        const std::size_t roomCount = _rooms.size();
+        const unsigned workers = static_cast<unsigned>(
+            std::max<std::size_t>(1, std::min<std::size_t>(_workers, roomCount / MinRoomsPerWorker)));
+        const std::size_t chunk = std::max<std::size_t>(1, (roomCount + workers - 1) / workers);
+        auto partitionOf = [chunk](std::size_t index) { return static_cast<unsigned>(index / chunk); };
+
+        // Phase 1: every worker builds its range of rooms into its own partition
+        std::vector<Room*> built(roomCount, nullptr);
+        RunWorkers(workers, [&](unsigned w) {
+            Wall* wall = WallFlyweights::Get<Wall>();
+            for (std::size_t i = w * chunk; i < std::min(roomCount, (w + 1) * chunk); ++i) {
+                built[i] = NewRoom(_rooms[i], wall);
+            }
+        });
+
+        // Phase 2: every worker buckets its share of the doors by partition
+        const std::size_t doorChunk = (_doors.size() + workers - 1) / workers;
+        std::vector<std::vector<std::vector<IndexPair>>> buckets(workers, std::vector<std::vector<IndexPair>>(workers));
+        std::vector<std::vector<RoomPair>> crossing(workers);
+        RunWorkers(workers, [&](unsigned w) {
+            for (std::size_t d = w * doorChunk; d < std::min(_doors.size(), (w + 1) * doorChunk); ++d) {
+                std::size_t i1 = indexOf(_doors[d].first);
+                std::size_t i2 = indexOf(_doors[d].second);
+                if (i1 != NoRoom && i2 != NoRoom && partitionOf(i1) == partitionOf(i2)) {
+                    buckets[w][partitionOf(i1)].emplace_back(i1, i2);
+                    continue;
+                }
+                // Crossing partitions, or reaching a room of an earlier GetMaze (read-only here)
+                Room* r1 = i1 != NoRoom ? built[i1] : _currentMaze->RoomNo(_doors[d].first);
+                Room* r2 = i2 != NoRoom ? built[i2] : _currentMaze->RoomNo(_doors[d].second);
+                if (r1 && r2) {
+                    crossing[w].emplace_back(r1, r2);
+                }
+            }
+        });
+
+        // Phase 3: every worker connects the doors inside its own partition
+        RunWorkers(workers, [&](unsigned p) {
+            for (unsigned w = 0; w < workers; ++w) {
+                for (const IndexPair& door : buckets[w][p]) {
+                    Connect(built[door.first], built[door.second]);
+                }
+            }
+        });
+
+        // Phase 4: merge the partitions and stitch the doors crossing them
+        _currentMaze->AddRooms(_rooms.data(), built.data(), roomCount, static_cast<int>(minNumber),
+                               static_cast<int>(maxNumber));
+        for (const auto& doors : crossing) {
+            for (const RoomPair& door : doors) {
+                Connect(door.first, door.second);
+            }
+        }
+
+        _rooms.clear();
+        _doors.clear();
+    }
+
+    unsigned _workers;
+    std::vector<int> _rooms;       // Recorded BuildRoom steps
+    std::vector<DoorPair> _doors;  // Recorded BuildDoor steps (room numbers)
+};
+
 // Director: Constructs the maze using the builder's interface
 class MazeGame {
 public:
@@ -180,6 +650,25 @@ public:
         builder.BuildDoor(1, 2);
         return builder.GetMaze();
     }
+
+    // Builds a corridor of `roomCount` rooms, each connected to the next by a door
+    Maze* CreateCorridorMaze(MazeBuilder& builder, int roomCount) {
+        std::vector<int> rooms;
+        std::vector<MazeBuilder::DoorPair> doors;
+        rooms.reserve(roomCount);
+        doors.reserve(roomCount);
+        for (int n = 1; n <= roomCount; ++n) {
+            rooms.push_back(n);
+            if (n < roomCount) {
+                doors.emplace_back(n, n + 1);
+            }
+        }
+
+        builder.BuildMaze();
+        builder.BuildRooms(rooms.data(), rooms.size());
+        builder.BuildDoors(doors.data(), doors.size());
+        return builder.GetMaze();
+    }
 };
 
 int main() {
@@ -189,6 +678,11 @@ int main() {
     
     // Cleanup (assuming ownership is handled here; in real code, use smart pointers)
     delete maze;
+
+    // Large mazes: the same director, with construction spread over all cores
+    ParallelMazeBuilder parallelBuilder;
+    Maze* bigMaze = game.CreateCorridorMaze(parallelBuilder, 1000000);
+    delete bigMaze;
     
     return 0;
 }
@@ -0,0 +1,1002 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/* Ignore the Below code from previous Builder */
+
+// Enum to represent directions for room sides
+enum Direction { North, South, East, West };
+
+// Abstract Product: Base class for all maze components
+class MapSite {
+public:
+    virtual void Enter() = 0; // Pure virtual interface method
+    virtual ~MapSite() = default; // Virtual destructor for proper cleanup
+};
+
+// Concrete Product: Room component
+class Room : public MapSite {
+public:
+    Room(int roomNumber) : _roomNumber(roomNumber) {}
+
+    // Get a side of the room based on direction
+    MapSite* GetSide(Direction direction) const {
+        return _sides[direction];
+    }
+
+    // Set a side of the room
+    void SetSide(Direction direction, MapSite* site) {
+        _sides[direction] = site;
+    }
+
+    // Get the room number
+    int GetRoomNumber() const { return _roomNumber; }
+
+    void Enter() override {} // Implementation of interface method
+
+private:
+    MapSite* _sides[4] = {}; // Room's sides (4 directions); non-owning, walls may be shared flyweights
+    int _roomNumber;         // Room identifier
+};
+
+// Concrete Product: Door component connecting two rooms
+class Door : public MapSite {
+public:
+    Door(Room* r1, Room* r2) : _room1(r1), _room2(r2), _isOpen(false) {}
+
+    // Get the room on the other side of the door
+    Room* OtherSideFrom(Room* room) {
+        return (room == _room1) ? _room2 : _room1;
+    }
+
+    // Rooms connected by this door, and its state
+    Room* GetRoom1() const { return _room1; }
+    Room* GetRoom2() const { return _room2; }
+    bool IsOpen() const { return _isOpen; }
+
+    void Enter() override {} // Implementation of interface method
+
+private:
+    Room* _room1;  // First connected room
+    Room* _room2;  // Second connected room
+    bool _isOpen;  // Door state
+};
+
+// Concrete Product: Wall component
+class Wall : public MapSite {
+public:
+    Wall() = default;
+    void Enter() override {} // Implementation of interface method
+};
+
+// Flyweight: one shared, stateless instance per wall kind (see Builder.cpp)
+class WallFlyweights {
+public:
+    template <class TWall = Wall>
+    static TWall* Get() {
+        static TWall instance;
+        return &instance;
+    }
+};
+
+// Product: The maze object graph built by the Creational examples
+class Maze {
+public:
+    Maze() = default;
+
+    // Add a room to the maze
+    void AddRoom(Room* room) { _rooms.push_back(room); }
+
+    // All rooms, in insertion order
+    const std::vector<Room*>& Rooms() const { return _rooms; }
+
+private:
+    std::vector<Room*> _rooms; // Collection of rooms in the maze
+};
+
+/*
+    CompactMaze : Struct-of-arrays representation of a Maze.
+
+    The object graph above stores every room as a separate heap object whose sides point to
+    further polymorphic heap objects, so walking the maze is pointer chasing through virtual
+    objects scattered across memory. CompactMaze instead gives every room a dense integer id
+    (0 .. RoomCount()-1) and stores each direction's sides in its own packed array of uint32_t:
+
+        _sides[North][id], _sides[South][id], _sides[East][id], _sides[West][id]
+
+    Each side is a tagged 32-bit value: the top 2 bits hold the tag and the low 30 bits the
+    payload. The largest payload (PayloadMask) is reserved to mark a reference to a room that
+    is not in the maze, so a maze holds at most MaxRooms = 2^30 - 1 rooms and doors.
+
+        EmptySide : nothing set
+        WallSide  : payload is the wall kind (0 = plain wall)
+        DoorSide  : payload is an index into the door arrays (_doorRoom1/_doorRoom2)
+        RoomSide  : payload is the id of the room directly on the other side (open passage)
+
+    Traversals (flood fill, pathfinding) only ever touch these flat arrays, so they run over
+    contiguous memory instead of missing the cache on every step.
+*/
+class CompactMaze {
+public:
+    using RoomId = std::uint32_t;
+    using Side = std::uint32_t;
+
+    enum SideTag : std::uint32_t { EmptySide = 0, WallSide = 1, DoorSide = 2, RoomSide = 3 };
+
+    static constexpr RoomId NoRoom = std::numeric_limits<RoomId>::max();
+    static constexpr std::uint32_t PayloadMask = (1u << 30) - 1;
+    static constexpr RoomId UnknownRoom = PayloadMask;   // Payload of a dangling room reference
+    static constexpr std::size_t MaxRooms = PayloadMask; // Ids 0 .. MaxRooms-1 fit below UnknownRoom
+
+    static constexpr Side MakeSide(SideTag tag, std::uint32_t payload = 0) {
+        return (static_cast<std::uint32_t>(tag) << 30) | (payload & PayloadMask);
+    }
+    static constexpr SideTag TagOf(Side side) { return static_cast<SideTag>(side >> 30); }
+    static constexpr std::uint32_t PayloadOf(Side side) { return side & PayloadMask; }
+
+    // Add a room with all sides empty; returns its dense id, or NoRoom once MaxRooms is reached
+    RoomId AddRoom(int roomNumber) {
+        if (_roomNumbers.size() >= MaxRooms) {
+            return NoRoom;
+        }
+        _roomNumbers.push_back(roomNumber);
+        for (auto& sides : _sides) {
+            sides.push_back(MakeSide(EmptySide));
+        }
+        return static_cast<RoomId>(_roomNumbers.size() - 1);
+    }
+
+    // Add a door between two rooms; returns the side value to store in both rooms, or a
+    // wall once MaxRooms doors exist (their index would no longer fit the payload)
+    Side AddDoor(RoomId room1, RoomId room2, bool isOpen = false) {
+        if (_doorRoom1.size() >= MaxRooms) {
+            return MakeSide(WallSide);
+        }
+        _doorRoom1.push_back(room1);
+        _doorRoom2.push_back(room2);
+        _doorOpen.push_back(isOpen);
+        return MakeSide(DoorSide, static_cast<std::uint32_t>(_doorRoom1.size() - 1));
+    }
+
+    // Door state and endpoints, addressed by door index (the payload of a DoorSide)
+    bool IsDoorOpen(std::uint32_t door) const { return _doorOpen[door] != 0; }
+    void SetDoorOpen(std::uint32_t door, bool isOpen) { _doorOpen[door] = isOpen; }
+    RoomId DoorRoom1(std::uint32_t door) const { return _doorRoom1[door]; }
+    RoomId DoorRoom2(std::uint32_t door) const { return _doorRoom2[door]; }
+
+    void SetSide(RoomId room, Direction direction, Side side) { _sides[direction][room] = side; }
+    Side GetSide(RoomId room, Direction direction) const { return _sides[direction][room]; }
+
+    // Room reached by leaving `room` through `direction`, or NoRoom if blocked
+    RoomId Neighbor(RoomId room, Direction direction) const {
+        Side side = _sides[direction][room];
+        switch (TagOf(side)) {
+        case DoorSide: {
+            std::uint32_t door = PayloadOf(side);
+            return _doorRoom1[door] == room ? _doorRoom2[door] : _doorRoom1[door];
+        }
+        case RoomSide:
+            return PayloadOf(side);
+        default:
+            return NoRoom;
+        }
+    }
+
+    int RoomNumber(RoomId room) const { return _roomNumbers[room]; }
+    std::size_t RoomCount() const { return _roomNumbers.size(); }
+    std::size_t DoorCount() const { return _doorRoom1.size(); }
+
+    // Converter from the object graph; rooms get ids in Maze insertion order
+    static CompactMaze FromMaze(const Maze& maze) {
+        CompactMaze compact;
+        const std::vector<Room*>& rooms = maze.Rooms();
+        if (rooms.size() > MaxRooms) {
+            return compact; // Too many rooms for 30-bit ids
+        }
+        compact.Reserve(rooms.size());
+
+        std::unordered_map<const Room*, RoomId> roomIds;
+        roomIds.reserve(rooms.size());
+        for (const Room* room : rooms) {
+            roomIds.emplace(room, compact.AddRoom(room->GetRoomNumber()));
+        }
+
+        std::unordered_map<const Door*, Side> doorSides;
+        for (const Room* room : rooms) {
+            RoomId id = roomIds[room];
+            for (int d = North; d <= West; ++d) {
+                Direction direction = static_cast<Direction>(d);
+                MapSite* site = room->GetSide(direction);
+                if (!site) {
+                    continue;
+                }
+                if (auto* door = dynamic_cast<Door*>(site)) {
+                    auto it = doorSides.find(door);
+                    if (it == doorSides.end()) {
+                        // A door is shared by both of its rooms: record it only once
+                        it = doorSides.emplace(door, compact.AddDoor(Lookup(roomIds, door->GetRoom1()),
+                                                                     Lookup(roomIds, door->GetRoom2()),
+                                                                     door->IsOpen())).first;
+                    }
+                    compact.SetSide(id, direction, it->second);
+                } else if (auto* neighbor = dynamic_cast<Room*>(site)) {
+                    compact.SetSide(id, direction, MakeSide(RoomSide, Lookup(roomIds, neighbor)));
+                } else {
+                    compact.SetSide(id, direction, MakeSide(WallSide));
+                }
+            }
+        }
+        return compact;
+    }
+
+    /*
+        SiteView : MapSite-compatible view for legacy callers.
+
+        A small value (maze pointer + side) that offers the familiar GetSide / OtherSideFrom /
+        GetRoomNumber / Enter operations without any MapSite objects behind it.
+    */
+    class SiteView {
+    public:
+        SiteView(const CompactMaze* maze, Side side) : _maze(maze), _side(side) {}
+
+        bool IsRoom() const { return TagOf(_side) == RoomSide; }
+        bool IsDoor() const { return TagOf(_side) == DoorSide; }
+        bool IsWall() const { return TagOf(_side) == WallSide; }
+
+        // Room operations
+        SiteView GetSide(Direction direction) const {
+            return SiteView(_maze, _maze->GetSide(PayloadOf(_side), direction));
+        }
+        int GetRoomNumber() const { return _maze->RoomNumber(PayloadOf(_side)); }
+
+        // Door operation: the room on the other side from `room`
+        SiteView OtherSideFrom(const SiteView& room) const {
+            std::uint32_t door = PayloadOf(_side);
+            RoomId from = PayloadOf(room._side);
+            RoomId other = _maze->_doorRoom1[door] == from ? _maze->_doorRoom2[door] : _maze->_doorRoom1[door];
+            return SiteView(_maze, MakeSide(RoomSide, other));
+        }
+
+        void Enter() const {} // Mirrors MapSite::Enter
+
+    private:
+        const CompactMaze* _maze;
+        Side _side;
+    };
+
+    // View of a room, addressed by dense id
+    SiteView RoomView(RoomId room) const { return SiteView(this, MakeSide(RoomSide, room)); }
+
+private:
+    void Reserve(std::size_t rooms) {
+        _roomNumbers.reserve(rooms);
+        for (auto& sides : _sides) {
+            sides.reserve(rooms);
+        }
+    }
+
+    static RoomId Lookup(const std::unordered_map<const Room*, RoomId>& roomIds, const Room* room) {
+        auto it = roomIds.find(room);
+        return it == roomIds.end() ? UnknownRoom : it->second;
+    }
+
+    std::vector<int> _roomNumbers;    // Room number of each dense id
+    std::vector<Side> _sides[4];      // SoA: one packed side array per direction
+    std::vector<RoomId> _doorRoom1;   // First room of each door
+    std::vector<RoomId> _doorRoom2;   // Second room of each door
+    std::vector<std::uint8_t> _doorOpen; // State of each door (1 = open)
+};
+
+// Flood fill over the compact representation: number of rooms reachable from `start`
+std::size_t FloodFill(const CompactMaze& maze, CompactMaze::RoomId start) {
+    std::vector<bool> visited(maze.RoomCount(), false);
+    std::vector<CompactMaze::RoomId> stack{start};
+    visited[start] = true;
+    std::size_t count = 0;
+    while (!stack.empty()) {
+        CompactMaze::RoomId room = stack.back();
+        stack.pop_back();
+        ++count;
+        for (int d = North; d <= West; ++d) {
+            CompactMaze::RoomId next = maze.Neighbor(room, static_cast<Direction>(d));
+            if (next != CompactMaze::NoRoom && next < maze.RoomCount() && !visited[next]) {
+                visited[next] = true;
+                stack.push_back(next);
+            }
+        }
+    }
+    return count;
+}
+
+/*
+    WorkerPool : Persistent threads for the traversal engine.
+
+    Level-synchronous BFS hands out one batch of work per level, and big mazes have thousands
+    of levels, so starting threads per batch (as ParallelMazeBuilder does once per phase) would
+    cost more than the work itself. Run(task) wakes the parked workers, runs task(0) on the
+    calling thread and task(1..Size()-1) on the pool, and returns when all of them finished.
+*/
+class WorkerPool {
+public:
+    explicit WorkerPool(unsigned workers) {
+        for (unsigned w = 1; w < std::max(1u, workers); ++w) {
+            _threads.emplace_back([this, w] { Loop(w); });
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+        for (auto& t : _threads) {
+            t.join();
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    unsigned Size() const { return static_cast<unsigned>(_threads.size()) + 1; }
+
+    template <class Task>
+    void Run(Task& task) {
+        std::lock_guard<std::mutex> run(_runMutex); // One batch at a time
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _task = &task;
+            _invoke = [](void* t, unsigned w) { (*static_cast<Task*>(t))(w); };
+            _pending = _threads.size();
+            ++_generation;
+        }
+        _wake.notify_all();
+        task(0u);
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait(lock, [this] { return _pending == 0; });
+    }
+
+private:
+    void Loop(unsigned w) {
+        std::uint64_t seen = 0;
+        for (;;) {
+            void* task;
+            void (*invoke)(void*, unsigned);
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wake.wait(lock, [&] { return _stop || _generation != seen; });
+                if (_stop) {
+                    return;
+                }
+                seen = _generation;
+                task = _task;
+                invoke = _invoke;
+            }
+            invoke(task, w);
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (--_pending == 0) {
+                _done.notify_one();
+            }
+        }
+    }
+
+    std::vector<std::thread> _threads;
+    std::mutex _runMutex;                          // Serializes Run callers
+    std::mutex _mutex;                             // Guards the fields below
+    std::condition_variable _wake;                 // Workers: a new batch (or stop)
+    std::condition_variable _done;                 // Run: all workers finished
+    void* _task = nullptr;                         // Current batch ...
+    void (*_invoke)(void*, unsigned) = nullptr;    // ... and how to call it
+    std::size_t _pending = 0;                      // Workers still running the batch
+    std::uint64_t _generation = 0;                 // Batch counter
+    bool _stop = false;
+};
+
+/*
+    MazeTraversal : BFS, shortest paths and connected components over a CompactMaze.
+
+    Distances(start) is a level-synchronous BFS: the rooms of one level (the frontier) are
+    expanded together, and every room reached for the first time forms the next frontier.
+    Small frontiers are expanded on the calling thread. Large ones are cut into one range per
+    worker; each worker takes Grain-sized chunks from its own range and, once that is empty,
+    steals chunks from the other ranges, so uneven levels still keep every worker busy. A room
+    is claimed with a compare-exchange on its distance, so each room joins exactly one worker's
+    part of the next frontier.
+
+    Components() labels rooms with a concurrent union-find (CAS linking, path halving): every
+    worker unites the rooms of its range with their neighbours, then the roots are numbered.
+
+    Doors are traversed in both directions, open or not. A query uses the instance's worker
+    pool and scratch ranges, so a MazeTraversal must not be shared between threads: give
+    every thread that runs queries its own instance.
+*/
+class MazeTraversal {
+public:
+    using RoomId = CompactMaze::RoomId;
+
+    static constexpr std::uint32_t Unreached = std::numeric_limits<std::uint32_t>::max();
+
+    explicit MazeTraversal(const CompactMaze& maze, unsigned threads = std::thread::hardware_concurrency())
+        : _maze(maze), _pool(threads), _ranges(new Range[_pool.Size()]) {}
+
+    // BFS distance (in steps) from `start` to every room; Unreached where there is no path
+    std::vector<std::uint32_t> Distances(RoomId start) {
+        const std::size_t roomCount = _maze.RoomCount();
+        std::unique_ptr<std::atomic<std::uint32_t>[]> distance(new std::atomic<std::uint32_t>[roomCount]);
+        for (std::size_t i = 0; i < roomCount; ++i) {
+            distance[i].store(Unreached, std::memory_order_relaxed);
+        }
+
+        std::vector<RoomId> frontier;
+        if (start < roomCount) {
+            distance[start].store(0, std::memory_order_relaxed);
+            frontier.push_back(start);
+        }
+        std::vector<std::vector<RoomId>> next(_pool.Size());
+
+        for (std::uint32_t level = 1; !frontier.empty(); ++level) {
+            // Visit one room of the frontier, claiming unreached neighbours for `out`
+            auto expand = [&](RoomId room, std::vector<RoomId>& out) {
+                for (int d = North; d <= West; ++d) {
+                    RoomId neighbor = _maze.Neighbor(room, static_cast<Direction>(d));
+                    if (neighbor >= roomCount) {
+                        continue; // Blocked, or a door to a room outside the maze
+                    }
+                    std::uint32_t expected = Unreached;
+                    if (distance[neighbor].load(std::memory_order_relaxed) == Unreached &&
+                        distance[neighbor].compare_exchange_strong(expected, level, std::memory_order_relaxed)) {
+                        out.push_back(neighbor);
+                    }
+                }
+            };
+
+            if (_pool.Size() == 1 || frontier.size() < ParallelFrontier) {
+                next[0].clear();
+                for (RoomId room : frontier) {
+                    expand(room, next[0]);
+                }
+                frontier.swap(next[0]);
+                continue;
+            }
+
+            const unsigned workers = _pool.Size();
+            const std::size_t chunk = (frontier.size() + workers - 1) / workers;
+            for (unsigned w = 0; w < workers; ++w) {
+                _ranges[w].next.store(std::min(frontier.size(), w * chunk), std::memory_order_relaxed);
+                _ranges[w].end = std::min(frontier.size(), (w + 1) * chunk);
+            }
+            auto task = [&](unsigned w) {
+                std::vector<RoomId>& out = next[w];
+                out.clear();
+                for (unsigned v = 0; v < workers; ++v) {
+                    Range& range = _ranges[(w + v) % workers]; // Own range first, then steal
+                    for (;;) {
+                        std::size_t begin = range.next.fetch_add(Grain, std::memory_order_relaxed);
+                        if (begin >= range.end) {
+                            break;
+                        }
+                        for (std::size_t i = begin; i < std::min(range.end, begin + Grain); ++i) {
+                            expand(frontier[i], out);
+                        }
+                    }
+                }
+            };
+            _pool.Run(task);
+
+            frontier.clear();
+            for (const auto& part : next) {
+                frontier.insert(frontier.end(), part.begin(), part.end());
+            }
+        }
+
+        std::vector<std::uint32_t> result(roomCount);
+        for (std::size_t i = 0; i < roomCount; ++i) {
+            result[i] = distance[i].load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+    // Rooms on a shortest path from `from` to `to` (both included); empty if unreachable.
+    // A single query stops as soon as `to` is reached, so it runs on the calling thread.
+    std::vector<RoomId> ShortestPath(RoomId from, RoomId to) const {
+        const std::size_t roomCount = _maze.RoomCount();
+        if (from >= roomCount || to >= roomCount) {
+            return {};
+        }
+        std::vector<RoomId> parent(roomCount, CompactMaze::NoRoom);
+        std::vector<RoomId> queue{from};
+        parent[from] = from;
+        for (std::size_t head = 0; head < queue.size() && parent[to] == CompactMaze::NoRoom; ++head) {
+            RoomId room = queue[head];
+            for (int d = North; d <= West; ++d) {
+                RoomId neighbor = _maze.Neighbor(room, static_cast<Direction>(d));
+                if (neighbor < roomCount && parent[neighbor] == CompactMaze::NoRoom) {
+                    parent[neighbor] = room;
+                    queue.push_back(neighbor);
+                }
+            }
+        }
+        if (parent[to] == CompactMaze::NoRoom) {
+            return {};
+        }
+        std::vector<RoomId> path{to};
+        while (path.back() != from) {
+            path.push_back(parent[path.back()]);
+        }
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+    // Component label (0 .. count-1) of every room; rooms share a label iff they are connected
+    std::vector<std::uint32_t> Components(std::size_t* count = nullptr) {
+        const std::size_t roomCount = _maze.RoomCount();
+        std::unique_ptr<std::atomic<RoomId>[]> parent(new std::atomic<RoomId>[roomCount]);
+        for (std::size_t i = 0; i < roomCount; ++i) {
+            parent[i].store(static_cast<RoomId>(i), std::memory_order_relaxed);
+        }
+
+        const unsigned workers = roomCount < ParallelFrontier ? 1 : _pool.Size();
+        const std::size_t chunk = (roomCount + workers - 1) / workers;
+        auto task = [&](unsigned w) {
+            if (w >= workers) {
+                return;
+            }
+            for (std::size_t i = w * chunk; i < std::min(roomCount, (w + 1) * chunk); ++i) {
+                for (int d = North; d <= West; ++d) {
+                    RoomId neighbor = _maze.Neighbor(static_cast<RoomId>(i), static_cast<Direction>(d));
+                    if (neighbor < roomCount && neighbor > i) { // Each connection once
+                        Unite(parent.get(), static_cast<RoomId>(i), neighbor);
+                    }
+                }
+            }
+        };
+        if (workers == 1) {
+            task(0u);
+        } else {
+            _pool.Run(task);
+        }
+
+        std::vector<std::uint32_t> labels(roomCount);
+        std::uint32_t components = 0;
+        for (std::size_t i = 0; i < roomCount; ++i) {
+            RoomId root = Find(parent.get(), static_cast<RoomId>(i));
+            // Roots are the smallest id of their component, so they are labelled first
+            labels[i] = root == i ? components++ : labels[root];
+        }
+        if (count) {
+            *count = components;
+        }
+        return labels;
+    }
+
+private:
+    static constexpr std::size_t ParallelFrontier = 2048; // Smaller levels run on one thread
+    static constexpr std::size_t Grain = 256;             // Rooms taken per chunk
+
+    // A worker's share of the frontier; padded so workers do not share cursor cache lines
+    struct alignas(64) Range {
+        std::atomic<std::size_t> next{0};
+        std::size_t end = 0;
+    };
+
+    static RoomId Find(std::atomic<RoomId>* parent, RoomId room) {
+        for (;;) {
+            RoomId up = parent[room].load(std::memory_order_relaxed);
+            if (up == room) {
+                return room;
+            }
+            RoomId upper = parent[up].load(std::memory_order_relaxed);
+            if (up != upper) {
+                parent[room].compare_exchange_weak(up, upper, std::memory_order_relaxed); // Path halving
+            }
+            room = upper;
+        }
+    }
+
+    // Links the larger root under the smaller, retrying if another worker moved it first
+    static void Unite(std::atomic<RoomId>* parent, RoomId a, RoomId b) {
+        for (;;) {
+            a = Find(parent, a);
+            b = Find(parent, b);
+            if (a == b) {
+                return;
+            }
+            if (a < b) {
+                std::swap(a, b);
+            }
+            RoomId expected = a;
+            if (parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed)) {
+                return;
+            }
+        }
+    }
+
+    const CompactMaze& _maze;
+    WorkerPool _pool;
+    std::unique_ptr<Range[]> _ranges;
+};
+
+/*
+    ReachabilityIndex : Incrementally maintained "can room A reach room B" over a CompactMaze.
+
+    Two rooms are connected by a passage (RoomSide) or by an open door between them; closed
+    doors and walls block. Every passage is kept as an undirected link in both rooms' link
+    lists, and rooms are grouped into components kept in a union-find forest, so Reachable is
+    two near-O(1) root lookups.
+
+        Opening a door / adding a passage : the two components are united (union by size)
+        Closing a door / removing a side  : two searches run in lockstep from the passage's
+                                            endpoints over the remaining links
+
+    If the two searches meet, the component is still connected and nothing changes. If one
+    of them runs out of rooms first, it has found the whole of its side, which becomes a new
+    component. Each component keeps its member list for this; lists are merged
+    smaller-into-larger.
+
+    Costs, with N the size of the component involved:
+
+        Opening a door   : O(smaller of the two components), to move its members
+        Closing, split   : O(smaller side), twice over (search, then relabelling)
+        Closing, no split: O(rooms searched until the searches meet), up to N on a long cycle
+
+    So the index is cheap when a change cuts off or rejoins a small region (a dead end, a
+    side room), but closing and reopening a door in the middle of a long corridor is O(N)
+    each time. Making that sub-linear needs a dynamic tree (Euler-tour or link-cut trees),
+    which this index does not use.
+
+    The maze must only be changed through OpenDoor/CloseDoor/SetSide while indexed; rooms
+    added to it afterwards are not indexed.
+*/
+class ReachabilityIndex {
+public:
+    using RoomId = CompactMaze::RoomId;
+
+    explicit ReachabilityIndex(CompactMaze& maze) : _maze(maze) { Rebuild(); }
+
+    void OpenDoor(std::uint32_t door) { SetDoorOpen(door, true); }
+    void CloseDoor(std::uint32_t door) { SetDoorOpen(door, false); }
+
+    // Replaces a side of `room` (CompactMaze::SetSide), keeping the index current
+    void SetSide(RoomId room, Direction direction, CompactMaze::Side side) {
+        if (room >= _label.size()) {
+            _maze.SetSide(room, direction, side);
+            return;
+        }
+        RoomId before = Passage(room, direction);
+        _maze.SetSide(room, direction, side);
+        Update(room, before, Passage(room, direction));
+    }
+
+    bool Reachable(RoomId from, RoomId to) {
+        if (from >= _label.size() || to >= _label.size()) {
+            return false;
+        }
+        return Root(_label[from]) == Root(_label[to]);
+    }
+
+    // Number of rooms `room` can reach, itself included
+    std::size_t ComponentSize(RoomId room) {
+        return room < _label.size() ? _members[Root(_label[room])].size() : 0;
+    }
+
+private:
+    // Room reached from `room` through `direction` right now, or NoRoom
+    RoomId Passage(RoomId room, Direction direction) const {
+        CompactMaze::Side side = _maze.GetSide(room, direction);
+        RoomId other = CompactMaze::NoRoom;
+        if (CompactMaze::TagOf(side) == CompactMaze::DoorSide) {
+            std::uint32_t door = CompactMaze::PayloadOf(side);
+            if (door < _maze.DoorCount() && _maze.IsDoorOpen(door)) {
+                // Only the door's own rooms can pass through it
+                if (_maze.DoorRoom1(door) == room) {
+                    other = _maze.DoorRoom2(door);
+                } else if (_maze.DoorRoom2(door) == room) {
+                    other = _maze.DoorRoom1(door);
+                }
+            }
+        } else if (CompactMaze::TagOf(side) == CompactMaze::RoomSide) {
+            other = CompactMaze::PayloadOf(side);
+        }
+        return other < _label.size() ? other : CompactMaze::NoRoom;
+    }
+
+    void SetDoorOpen(std::uint32_t door, bool isOpen) {
+        if (door >= _maze.DoorCount() || _maze.IsDoorOpen(door) == isOpen) {
+            return;
+        }
+        // The sides holding this door, on either of its (indexed) rooms, and where they led
+        struct DoorSide {
+            RoomId room;
+            Direction direction;
+            RoomId before;
+        };
+        DoorSide sides[8];
+        int count = 0;
+        const RoomId rooms[2] = {_maze.DoorRoom1(door), _maze.DoorRoom2(door)};
+        for (int r = 0; r < 2; ++r) {
+            if (rooms[r] >= _label.size() || (r == 1 && rooms[1] == rooms[0])) {
+                continue;
+            }
+            for (int d = North; d <= West; ++d) {
+                Direction direction = static_cast<Direction>(d);
+                if (_maze.GetSide(rooms[r], direction) == CompactMaze::MakeSide(CompactMaze::DoorSide, door)) {
+                    sides[count++] = DoorSide{rooms[r], direction, Passage(rooms[r], direction)};
+                }
+            }
+        }
+        _maze.SetDoorOpen(door, isOpen);
+        for (int i = 0; i < count; ++i) {
+            Update(sides[i].room, sides[i].before, Passage(sides[i].room, sides[i].direction));
+        }
+    }
+
+    // A side of `room` that led to `before` now leads to `after`
+    void Update(RoomId room, RoomId before, RoomId after) {
+        if (before == after) {
+            return;
+        }
+        if (before != CompactMaze::NoRoom) {
+            Unlink(room, before);
+        }
+        if (after != CompactMaze::NoRoom) {
+            _links[room].push_back(after);
+            _links[after].push_back(room);
+            Unite(room, after);
+        }
+    }
+
+    // Removes one link between a and b and splits their component if that disconnected them
+    void Unlink(RoomId a, RoomId b) {
+        RemoveLink(a, b);
+        RemoveLink(b, a);
+        if (a == b || Root(_label[a]) != Root(_label[b])) {
+            return;
+        }
+        if (++_stamp == 0) { // Wrapped: forget every old mark
+            std::fill(_mark.begin(), _mark.end(), 0);
+            _stamp = 1;
+        }
+        std::vector<RoomId>* queues[2] = {&_searchA, &_searchB};
+        const RoomId starts[2] = {a, b};
+        std::size_t heads[2] = {0, 0};
+        for (int s = 0; s < 2; ++s) {
+            queues[s]->assign(1, starts[s]);
+            _mark[starts[s]] = _stamp;
+            _searchSide[starts[s]] = static_cast<std::uint8_t>(s);
+        }
+        for (int s = 0; ; s ^= 1) {
+            std::vector<RoomId>& queue = *queues[s];
+            if (heads[s] == queue.size()) {
+                SplitOff(queue); // This side is complete and never met the other one
+                return;
+            }
+            RoomId room = queue[heads[s]++];
+            for (RoomId next : _links[room]) {
+                if (_mark[next] == _stamp) {
+                    if (_searchSide[next] != s) {
+                        return; // The searches met: still one component
+                    }
+                    continue;
+                }
+                _mark[next] = _stamp;
+                _searchSide[next] = static_cast<std::uint8_t>(s);
+                queue.push_back(next);
+            }
+        }
+    }
+
+    void RemoveLink(RoomId from, RoomId to) {
+        std::vector<RoomId>& links = _links[from];
+        auto it = std::find(links.begin(), links.end(), to);
+        if (it != links.end()) {
+            *it = links.back();
+            links.pop_back();
+        }
+    }
+
+    // Moves `rooms` (all of one side of a former component) into a component of their own
+    void SplitOff(const std::vector<RoomId>& rooms) {
+        std::uint32_t root = Root(_label[rooms.front()]);
+        std::uint32_t node = NewNode();
+        std::vector<RoomId>& members = _members[root];
+        for (RoomId room : rooms) {
+            RoomId last = members.back();
+            members[_position[room]] = last;
+            _position[last] = _position[room];
+            members.pop_back();
+            _label[room] = node;
+            _position[room] = static_cast<std::uint32_t>(_members[node].size());
+            _members[node].push_back(room);
+        }
+        // Retired nodes accumulate; renumber the live ones once they dominate
+        if (_parent.size() > 4 * _label.size() + 64) {
+            Compact();
+        }
+    }
+
+    std::uint32_t Root(std::uint32_t node) {
+        while (_parent[node] != node) {
+            _parent[node] = _parent[_parent[node]]; // Path halving
+            node = _parent[node];
+        }
+        return node;
+    }
+
+    std::uint32_t NewNode() {
+        _parent.push_back(static_cast<std::uint32_t>(_parent.size()));
+        _members.emplace_back();
+        return _parent.back();
+    }
+
+    void Unite(RoomId a, RoomId b) {
+        std::uint32_t rootA = Root(_label[a]);
+        std::uint32_t rootB = Root(_label[b]);
+        if (rootA == rootB) {
+            return;
+        }
+        if (_members[rootA].size() < _members[rootB].size()) {
+            std::swap(rootA, rootB);
+        }
+        _parent[rootB] = rootA;
+        for (RoomId room : _members[rootB]) {
+            _position[room] = static_cast<std::uint32_t>(_members[rootA].size());
+            _members[rootA].push_back(room);
+        }
+        std::vector<RoomId>().swap(_members[rootB]);
+    }
+
+    // One node per live component again; the components themselves do not change
+    void Compact() {
+        std::vector<std::vector<RoomId>> members;
+        for (std::uint32_t node = 0; node < _parent.size(); ++node) {
+            if (_parent[node] == node && !_members[node].empty()) {
+                for (RoomId room : _members[node]) {
+                    _label[room] = static_cast<std::uint32_t>(members.size());
+                }
+                members.push_back(std::move(_members[node]));
+            }
+        }
+        _members = std::move(members);
+        _parent.resize(_members.size());
+        for (std::uint32_t node = 0; node < _parent.size(); ++node) {
+            _parent[node] = node;
+        }
+    }
+
+    // Links and components from scratch: one search per component, O(rooms + passages)
+    void Rebuild() {
+        const std::size_t roomCount = _maze.RoomCount();
+        _label.assign(roomCount, 0);
+        _position.assign(roomCount, 0);
+        _mark.assign(roomCount, 0);
+        _searchSide.assign(roomCount, 0);
+        _stamp = 1;
+        _links.assign(roomCount, std::vector<RoomId>());
+        for (RoomId room = 0; room < roomCount; ++room) {
+            for (int d = North; d <= West; ++d) {
+                RoomId other = Passage(room, static_cast<Direction>(d));
+                if (other != CompactMaze::NoRoom) {
+                    _links[room].push_back(other);
+                    _links[other].push_back(room);
+                }
+            }
+        }
+        _parent.clear();
+        _members.clear();
+        for (RoomId start = 0; start < roomCount; ++start) {
+            if (_mark[start] == _stamp) {
+                continue;
+            }
+            std::uint32_t node = NewNode();
+            std::vector<RoomId>& members = _members[node];
+            _mark[start] = _stamp;
+            members.push_back(start);
+            for (std::size_t head = 0; head < members.size(); ++head) {
+                for (RoomId next : _links[members[head]]) {
+                    if (_mark[next] != _stamp) {
+                        _mark[next] = _stamp;
+                        members.push_back(next);
+                    }
+                }
+            }
+            for (std::uint32_t i = 0; i < members.size(); ++i) {
+                _label[members[i]] = node;
+                _position[members[i]] = i;
+            }
+        }
+    }
+
+    CompactMaze& _maze;
+    std::vector<std::vector<RoomId>> _links;         // Room -> rooms it has a passage with (both ways)
+    std::vector<std::uint32_t> _label;               // Room -> union-find node
+    std::vector<std::uint32_t> _parent;              // Union-find forest over nodes
+    std::vector<std::vector<RoomId>> _members;       // Rooms of each root node
+    std::vector<std::uint32_t> _position;            // Room -> index in its root's member list
+    std::vector<std::uint32_t> _mark;                // Search scratch: stamp of the last visit
+    std::vector<std::uint8_t> _searchSide;           // Search scratch: which endpoint reached the room
+    std::vector<RoomId> _searchA;                    // Search scratch: queues of the two searches
+    std::vector<RoomId> _searchB;
+    std::uint32_t _stamp = 0;                        // Current search
+};
+
+// Builds a width x height grid of rooms: doors connect every row east-west and the rows
+// are joined into a snake at alternating ends.
+Maze* CreateGridMaze(int width, int height) {
+    Maze* maze = new Maze;
+    std::vector<Room*> rooms;
+    rooms.reserve(static_cast<std::size_t>(width) * height);
+    for (int n = 0; n < width * height; ++n) {
+        Room* room = new Room(n);
+        Wall* wall = WallFlyweights::Get<Wall>();
+        room->SetSide(North, wall);
+        room->SetSide(South, wall);
+        room->SetSide(East, wall);
+        room->SetSide(West, wall);
+        maze->AddRoom(room);
+        rooms.push_back(room);
+    }
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x + 1 < width; ++x) {
+            Room* r1 = rooms[y * width + x];
+            Room* r2 = rooms[y * width + x + 1];
+            Door* door = new Door(r1, r2);
+            r1->SetSide(East, door);
+            r2->SetSide(West, door);
+        }
+        if (y + 1 < height) {
+            int x = (y % 2 == 0) ? width - 1 : 0;
+            Room* r1 = rooms[y * width + x];
+            Room* r2 = rooms[(y + 1) * width + x];
+            Door* door = new Door(r1, r2);
+            r1->SetSide(South, door);
+            r2->SetSide(North, door);
+        }
+    }
+    return maze;
+}
+
+int main() {
+    Maze* maze = CreateGridMaze(100, 100);
+    CompactMaze compact = CompactMaze::FromMaze(*maze);
+
+    std::cout << "Rooms: " << compact.RoomCount() << ", doors: " << compact.DoorCount() << std::endl;
+    std::cout << "Reachable from room 0: " << FloodFill(compact, 0) << std::endl;
+
+    // Legacy-style navigation through the view: leave room 0 through its east door
+    CompactMaze::SiteView room0 = compact.RoomView(0);
+    CompactMaze::SiteView east = room0.GetSide(East);
+    if (east.IsDoor()) {
+        std::cout << "Room 0 east door leads to room " << east.OtherSideFrom(room0).GetRoomNumber() << std::endl;
+    }
+
+    // Traversal engine: distances, shortest path and components
+    MazeTraversal traversal(compact);
+    std::vector<std::uint32_t> distances = traversal.Distances(0);
+    std::vector<CompactMaze::RoomId> path = traversal.ShortestPath(0, static_cast<CompactMaze::RoomId>(compact.RoomCount() - 1));
+    std::size_t components = 0;
+    traversal.Components(&components);
+    std::cout << "Distance to last room: " << distances.back() << ", path length: " << path.size()
+              << ", components: " << components << std::endl;
+
+    // Reachability as doors are toggled: the grid starts with every door closed
+    ReachabilityIndex reachability(compact);
+    const CompactMaze::RoomId last = static_cast<CompactMaze::RoomId>(compact.RoomCount() - 1);
+    std::cout << std::boolalpha << "Room " << last << " reachable from room 0: " << reachability.Reachable(0, last);
+    for (std::uint32_t door = 0; door < compact.DoorCount(); ++door) {
+        reachability.OpenDoor(door);
+    }
+    std::cout << ", after opening all doors: " << reachability.Reachable(0, last);
+    reachability.CloseDoor(static_cast<std::uint32_t>(compact.DoorCount() / 2));
+    std::cout << ", after closing the middle door: " << reachability.Reachable(0, last)
+              << " (" << reachability.ComponentSize(0) << " rooms reachable)" << std::endl;
+
+    return 0;
+}
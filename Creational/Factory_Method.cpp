@@ -1,4 +1,12 @@
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
 #include <vector>
 // Enum to represent directions for room sides
 enum Direction { North, South, East, West };
@@ -14,6 +22,7 @@ public:
 class Room : public MapSite {
 public:
     Room(int roomNumber) : _roomNumber(roomNumber) {}
+    Room() : Room(0) {} // Default-constructible for ProductRegistry
     
     // Get a side of the room based on direction
     MapSite* GetSide(Direction direction) const {
@@ -24,11 +33,14 @@ public:
     void SetSide(Direction direction, MapSite* site) {
         _sides[direction] = site;
     }
+
+    // Get the room number
+    int GetRoomNumber() const { return _roomNumber; }
     
     void Enter() override {} // Implementation of interface method
 
 private:
-    MapSite* _sides[4] = {}; // Array to hold room's sides (4 directions)
+    MapSite* _sides[4] = {}; // Room's sides (4 directions); non-owning, walls may be shared flyweights
     int _roomNumber;         // Room identifier
 };
 
@@ -36,6 +48,7 @@ private:
 class Door : public MapSite {
 public:
     Door(Room* r1, Room* r2) : _room1(r1), _room2(r2) {}
+    Door() : Door(nullptr, nullptr) {} // Default-constructible for ProductRegistry
     
     // Get the room on the other side of the door
     Room* OtherSideFrom(Room* room) {
@@ -57,6 +70,23 @@ public:
     void Enter() override {} // Implementation of interface method
 };
 
+// Concrete Product: Wall variant used by bombed mazes
+class BombedWall : public Wall {
+public:
+    BombedWall() = default;
+    void Enter() override {} // Implementation of interface method
+};
+
+// Flyweight: one shared, stateless instance per wall kind (see Builder.cpp)
+class WallFlyweights {
+public:
+    template <class TWall = Wall>
+    static TWall* Get() {
+        static TWall instance; // Constructed once, on first use (thread-safe since C++11)
+        return &instance;
+    }
+};
+
 
 class Maze {
 public:
@@ -162,6 +192,28 @@ class MazeGame
 {
     public:
     Maze* CreateMaze();
+    Maze* CreateMaze(int roomCount); // Rooms 1..roomCount joined as Neighbor describes
+    
+    // Layout: the room behind `side` of room n (1..roomCount), or 0 for a wall. Layouts are
+    // symmetric: if that room is m, the opposite side of m leads back to n. The default is a
+    // corridor running east; CreateMaze() is its two-room instance.
+    virtual int Neighbor(int n, Direction side, int roomCount) const
+    {
+        if (side == East && n < roomCount) return n + 1;
+        if (side == West && n > 1) return n - 1;
+        return 0;
+    }
+
+    static Direction Opposite(Direction side)
+    {
+        switch (side) 
+        {
+        case North: return South;
+        case South: return North;
+        case East:  return West;
+        default:    return East;
+        }
+    }
     
     // factory methods:
     virtual Maze* MakeMaze() const
@@ -171,7 +223,7 @@ class MazeGame
     { return new Room(n); }
     
     virtual Wall* MakeWall() const
-    { return new Wall; }
+    { return WallFlyweights::Get<Wall>(); } // Shared, never deleted
     
     virtual Door* MakeDoor(Room* rl, Room* r2) const
     { return new Door(rl, r2); }
@@ -179,23 +231,401 @@ class MazeGame
 
 Maze* MazeGame::CreateMaze () 
 {
-    Maze* aMaze = MakeMaze ();
-    Room* r1 = MakeRoom (1);
-    Room* r2 = MakeRoom(2);
-    Door* theDoor = MakeDoor(r1, r2);
-    aMaze->AddRoom(r1);
-    aMaze->AddRoom(r2);
-    r1->SetSide(North, MakeWall());
-    r1->SetSide(East, theDoor);
-    r1->SetSide(South, MakeWall());
-    r1->SetSide(West, MakeWall());
-    r2->SetSide(North, MakeWall());
-    r2->SetSide(East, MakeWall());
-    r2->SetSide(South, MakeWall());
-    r2->SetSide(West, theDoor);
+    return CreateMaze(2); // r1 -East door West- r2, walls everywhere else
+}
+
+Maze* MazeGame::CreateMaze(int roomCount) 
+{
+    Maze* aMaze = MakeMaze();
+    std::vector<Room*> rooms(roomCount > 0 ? roomCount + 1 : 1, nullptr);
+    for (int n = 1; n <= roomCount; ++n) 
+    {
+        rooms[n] = MakeRoom(n);
+        aMaze->AddRoom(rooms[n]);
+    }
+    for (int n = 1; n <= roomCount; ++n) 
+    {
+        for (int d = North; d <= West; ++d) 
+        {
+            Direction side = static_cast<Direction>(d);
+            int m = Neighbor(n, side, roomCount);
+            if (m == 0) 
+            {
+                rooms[n]->SetSide(side, MakeWall());
+            }
+            else if (n < m) // Each door is made once, from its lower-numbered room
+            {
+                Door* theDoor = MakeDoor(rooms[n], rooms[m]);
+                rooms[n]->SetSide(side, theDoor);
+                rooms[m]->SetSide(Opposite(side), theDoor);
+            }
+        }
+    }
     return aMaze;
 }
 
+/*
+    Using templates to avoid subclassing (see Implementation above).
+
+    StandardCreator<TheProduct> creates TheProduct directly, so instead of a MazeGame subclass
+    per product family the families become template arguments of StaticMazeGame. Its
+    CreateMaze is bound entirely at compile time: no virtual factory method is involved, and
+    the compiler can inline every creation step. MazeGame and its virtual factory methods stay
+    available for families chosen at run time.
+*/
+template <class TheProduct>
+class StandardCreator 
+{
+    public:
+    template <class... Args>
+    static TheProduct* CreateProduct(Args&&... args)
+    { return new TheProduct(std::forward<Args>(args)...); }
+};
+
+template <class TheRoom = Room, class TheWall = Wall, class TheDoor = Door>
+class StaticMazeGame 
+{
+    public:
+    Maze* CreateMaze() const 
+    {
+        Maze* aMaze = StandardCreator<Maze>::CreateProduct();
+        Room* r1 = StandardCreator<TheRoom>::CreateProduct(1);
+        Room* r2 = StandardCreator<TheRoom>::CreateProduct(2);
+        Door* theDoor = StandardCreator<TheDoor>::CreateProduct(r1, r2);
+        Wall* wall = WallFlyweights::Get<TheWall>(); // Walls are shared flyweights
+        aMaze->AddRoom(r1);
+        aMaze->AddRoom(r2);
+        r1->SetSide(North, wall);
+        r1->SetSide(East, theDoor);
+        r1->SetSide(South, wall);
+        r1->SetSide(West, wall);
+        r2->SetSide(North, wall);
+        r2->SetSide(East, wall);
+        r2->SetSide(South, wall);
+        r2->SetSide(West, theDoor);
+        return aMaze;
+    }
+};
+
+/*
+    Parameterized factory method with a registry (see Creator::Create(ProductId) above).
+
+    Instead of a chain of "if (id == MINE) ... if (id == YOURS)" tests, the product classes are
+    registered for their ids at compile time:
+
+        using MazeProducts = ProductRegistry<ProductEntry<RoomProduct, Room>,
+                                             ProductEntry<WallProduct, Wall>, ...>;
+
+    From the registered ids the registry computes, at compile time, the smallest modulus M for
+    which "id % M" is different for every id: a perfect hash. Create(id) is then one modulo by
+    a constant, one table load, one id check and an indirect call through the jump table, no
+    matter how many products are registered.
+
+    CreateN(id, count) constructs `count` products of one kind into a single contiguous block
+    (one allocation instead of `count`), returned as a ProductArray that owns them.
+*/
+
+// Product tags as they appear in level files
+enum ProductId : std::uint32_t 
+{
+    RoomProduct = 'R',
+    WallProduct = 'W',
+    DoorProduct = 'D',
+    BombedWallProduct = 'B'
+};
+
+template <ProductId Id, class TheProduct>
+struct ProductEntry 
+{
+    static constexpr ProductId id = Id;
+    using Product = TheProduct;
+};
+
+// Products of one kind, constructed side by side in a single block
+class ProductArray 
+{
+    public:
+    ProductArray() = default;
+    ProductArray(ProductArray&& other) noexcept { *this = std::move(other); }
+    ProductArray& operator=(ProductArray&& other) noexcept 
+    {
+        std::swap(_storage, other._storage);
+        std::swap(_count, other._count);
+        std::swap(_stride, other._stride);
+        std::swap(_alignment, other._alignment);
+        std::swap(_destroy, other._destroy);
+        std::swap(_upcast, other._upcast);
+        return *this;
+    }
+    ~ProductArray() 
+    {
+        for (std::size_t i = 0; i < _count; ++i) 
+        {
+            _destroy(_storage + i * _stride);
+        }
+        if (_storage) 
+        {
+            ::operator delete(_storage, std::align_val_t(_alignment));
+        }
+    }
+
+    std::size_t size() const { return _count; }
+    MapSite* operator[](std::size_t i) const { return _upcast(_storage + i * _stride); }
+
+    private:
+    template <class... Entries> friend class ProductRegistry;
+
+    std::byte* _storage = nullptr;
+    std::size_t _count = 0;
+    std::size_t _stride = 0;
+    std::size_t _alignment = alignof(std::max_align_t);
+    void (*_destroy)(void*) = nullptr;
+    MapSite* (*_upcast)(void*) = nullptr;
+};
+
+template <class... Entries>
+class ProductRegistry 
+{
+    static_assert(sizeof...(Entries) > 0, "ProductRegistry needs at least one product");
+
+    public:
+    // One product for `id`, or nullptr for an unknown id
+    static MapSite* Create(ProductId id) 
+    {
+        const Slot& slot = _table[id % Modulus];
+        return slot.id == id && slot.create ? slot.create() : nullptr;
+    }
+
+    // `count` products for `id` in one contiguous block (empty for an unknown id)
+    static ProductArray CreateN(ProductId id, std::size_t count) 
+    {
+        ProductArray products;
+        const Slot& slot = _table[id % Modulus];
+        if (slot.id != id || !slot.create || count == 0) 
+        {
+            return products;
+        }
+        products._stride = slot.size;
+        products._alignment = slot.alignment;
+        products._destroy = slot.destroy;
+        products._upcast = slot.upcast;
+        products._storage = static_cast<std::byte*>(::operator new(count * slot.size, std::align_val_t(slot.alignment)));
+        for (; products._count < count; ++products._count) 
+        {
+            slot.construct(products._storage + products._count * slot.size);
+        }
+        return products;
+    }
+
+    private:
+    struct Slot 
+    {
+        ProductId id{};
+        MapSite* (*create)() = nullptr; // nullptr marks an empty slot
+        void (*construct)(void*) = nullptr;
+        void (*destroy)(void*) = nullptr;
+        MapSite* (*upcast)(void*) = nullptr;
+        std::size_t size = 0;
+        std::size_t alignment = 0;
+    };
+
+    template <class T> static MapSite* CreateOne() { return new T; }
+    template <class T> static void ConstructAt(void* p) { new (p) T; }
+    template <class T> static void DestroyAt(void* p) { static_cast<T*>(p)->~T(); }
+    template <class T> static MapSite* Upcast(void* p) { return static_cast<T*>(p); }
+
+    static constexpr std::array<std::uint32_t, sizeof...(Entries)> _ids{{Entries::id...}};
+
+    // Smallest M >= number of products for which id % M is unique: the perfect hash
+    static constexpr std::size_t FindModulus() 
+    {
+        for (std::size_t m = _ids.size(); ; ++m) 
+        {
+            bool unique = true;
+            for (std::size_t i = 0; i < _ids.size() && unique; ++i) 
+            {
+                for (std::size_t j = i + 1; j < _ids.size() && unique; ++j) 
+                {
+                    unique = _ids[i] % m != _ids[j] % m;
+                }
+            }
+            if (unique) 
+            {
+                return m;
+            }
+        }
+    }
+
+    static constexpr std::size_t Modulus = FindModulus();
+
+    static constexpr std::array<Slot, Modulus> BuildTable() 
+    {
+        std::array<Slot, Modulus> table{};
+        ((table[Entries::id % Modulus] = Slot{Entries::id,
+                                              &CreateOne<typename Entries::Product>,
+                                              &ConstructAt<typename Entries::Product>,
+                                              &DestroyAt<typename Entries::Product>,
+                                              &Upcast<typename Entries::Product>,
+                                              sizeof(typename Entries::Product),
+                                              alignof(typename Entries::Product)}), ...);
+        return table;
+    }
+
+    static constexpr std::array<Slot, Modulus> _table = BuildTable();
+};
+
+using MazeProducts = ProductRegistry<ProductEntry<RoomProduct, Room>,
+                                     ProductEntry<WallProduct, Wall>,
+                                     ProductEntry<DoorProduct, Door>,
+                                     ProductEntry<BombedWallProduct, BombedWall>>;
+
+/*
+    Lazy initialization (see Creator::GetProduct above), made thread-safe.
+
+    Lazy<T> holds a product that is only created on first access. Get(create) calls `create`
+    exactly once, even when several threads ask at the same time, and afterwards costs a
+    single acquire load. Like GetProduct/CreateProduct, the accessor does not know how the
+    product is made: the creator passes its factory method in.
+
+    LazyMaze applies it to a whole maze. It describes the same maze as
+    MazeGame::CreateMaze(roomCount), following the game's Neighbor layout, but builds nothing
+    up front. A room is materialized, with its walls and doors, the first time it is looked
+    up through RoomNo; the rooms a player never visits are never built. Every component comes
+    from the game's factory methods (MakeRoom, MakeWall, MakeDoor), so MazeGame subclasses
+    get their own products, lazily.
+
+    A room is materialized in two steps so that neighbours never wait on each other: its
+    "shell" (the Room from MakeRoom) is created on demand by either side of a door, while its
+    "furnishing" (setting the sides) only ever happens once, for that room itself.
+
+    Per-room state lives in pages of PageSize slots, each created on first touch, so a maze
+    costs one Lazy page pointer per PageSize rooms until it is visited. The maze owns what it
+    materialized: rooms and doors are deleted with it (walls are the shared flyweights).
+*/
+template <class T>
+class Lazy 
+{
+    public:
+    template <class Create>
+    T* Get(Create&& create) 
+    {
+        T* product = _product.load(std::memory_order_acquire);
+        if (product == nullptr) 
+        {
+            std::call_once(_once, [&] { _product.store(create(), std::memory_order_release); });
+            product = _product.load(std::memory_order_acquire);
+        }
+        return product;
+    }
+
+    bool IsCreated() const { return _product.load(std::memory_order_acquire) != nullptr; }
+
+    // The product, or nullptr if it was never created
+    T* Peek() const { return _product.load(std::memory_order_acquire); }
+
+    private:
+    std::once_flag _once;
+    std::atomic<T*> _product{nullptr};
+};
+
+class LazyMaze 
+{
+    public:
+    LazyMaze(const MazeGame& game, int roomCount)
+        : _game(game), _roomCount(roomCount > 0 ? roomCount : 0),
+          _pages(new Lazy<Page>[(_roomCount + PageSize - 1) / PageSize]) {}
+
+    LazyMaze(const LazyMaze&) = delete;
+    LazyMaze& operator=(const LazyMaze&) = delete;
+
+    ~LazyMaze() 
+    {
+        for (int p = 0; p < (_roomCount + PageSize - 1) / PageSize; ++p) 
+        {
+            Page* page = _pages[p].Peek();
+            if (page == nullptr) 
+            {
+                continue;
+            }
+            for (Slot& slot : page->slots) 
+            {
+                for (Lazy<Door>& door : slot.doors) 
+                {
+                    delete door.Peek();
+                }
+                delete slot.shell.Peek();
+            }
+            delete page;
+        }
+    }
+
+    // Room `n` (1..RoomCount), materialized with its walls and doors on first access
+    Room* RoomNo(int n) 
+    {
+        if (n < 1 || n > _roomCount) 
+        {
+            return nullptr;
+        }
+        return SlotOf(n).furnished.Get([&] { return Furnish(n); });
+    }
+
+    int RoomCount() const { return _roomCount; }
+    int MaterializedRooms() const { return _materialized.load(std::memory_order_relaxed); }
+
+    private:
+    static constexpr int PageSize = 64;
+
+    struct Slot 
+    {
+        Lazy<Room> shell;     // The Room object itself
+        Lazy<Room> furnished; // The same Room, once its sides are set
+        Lazy<Door> doors[4];  // Doors on the sides leading to higher-numbered rooms
+    };
+
+    struct Page 
+    {
+        Slot slots[PageSize];
+    };
+
+    Slot& SlotOf(int n) 
+    {
+        Page* page = _pages[(n - 1) / PageSize].Get([] { return new Page; });
+        return page->slots[(n - 1) % PageSize];
+    }
+
+    Room* Shell(int n) 
+    {
+        return SlotOf(n).shell.Get([&] { return _game.MakeRoom(n); });
+    }
+
+    // Door on `side` of room n, leading to room m; kept by the lower-numbered of the two
+    Door* DoorBetween(int n, Direction side, int m) 
+    {
+        int low = n < m ? n : m;
+        int high = n < m ? m : n;
+        Direction lowSide = n < m ? side : MazeGame::Opposite(side);
+        return SlotOf(low).doors[lowSide].Get([&] { return _game.MakeDoor(Shell(low), Shell(high)); });
+    }
+
+    Room* Furnish(int n) 
+    {
+        Room* room = Shell(n);
+        for (int d = North; d <= West; ++d) 
+        {
+            Direction side = static_cast<Direction>(d);
+            int m = _game.Neighbor(n, side, _roomCount);
+            room->SetSide(side, m == 0 ? static_cast<MapSite*>(_game.MakeWall()) : DoorBetween(n, side, m));
+        }
+        _materialized.fetch_add(1, std::memory_order_relaxed);
+        return room;
+    }
+
+    const MazeGame& _game;
+    int _roomCount;
+    std::unique_ptr<Lazy<Page>[]> _pages; // One lazily created page per PageSize rooms
+    std::atomic<int> _materialized{0};
+};
+
 /*
 New concrete class
 
@@ -204,7 +634,7 @@ class BombedMazeGame : public MazeGame
     public:
     BombedMazeGame();
     virtual Wall* MakeWall() const
-    { return new BombedWall; }
+    { return WallFlyweights::Get<BombedWall>(); }
     virtual Room* MakeRoom(int n) const
     { return new RoomWithABomb(n); }
 };
@@ -216,5 +646,29 @@ int main() {
    MazeGame game;
    game.CreateMaze();
 
+   // Same maze, product family fixed at compile time (here: bombed walls)
+   StaticMazeGame<Room, BombedWall> bombedGame;
+   bombedGame.CreateMaze();
+
+   // Tagged components from a level file: single products, then a whole run of rooms at once
+   for (char tag : {'R', 'D', 'W', 'B', 'X'}) 
+   {
+       MapSite* product = MazeProducts::Create(static_cast<ProductId>(tag));
+       std::cout << tag << (product ? " -> created" : " -> unknown id") << std::endl;
+       delete product;
+   }
+   ProductArray rooms = MazeProducts::CreateN(RoomProduct, 1000);
+   std::cout << "CreateN: " << rooms.size() << " rooms in one block" << std::endl;
+
+   // Procedurally generated maze: only the rooms the player walks through get built
+   LazyMaze lazyMaze(game, 1000000);
+   Room* room = lazyMaze.RoomNo(1);
+   for (int step = 0; step < 10; ++step) 
+   {
+       Door* door = static_cast<Door*>(room->GetSide(East));
+       room = lazyMaze.RoomNo(door->OtherSideFrom(room)->GetRoomNumber()); // Materializes the next room
+   }
+   std::cout << "Materialized " << lazyMaze.MaterializedRooms() << " of " << lazyMaze.RoomCount() << " rooms" << std::endl;
+
     return 0;
 }
@@ -0,0 +1,801 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Ignore the Below code from previous Builder */
+
+// Enum to represent directions for room sides
+enum Direction { North, South, East, West };
+
+// Abstract Product: Base class for all maze components
+class MapSite {
+public:
+    virtual void Enter() = 0; // Pure virtual interface method
+    virtual ~MapSite() = default; // Virtual destructor for proper cleanup
+};
+
+// Concrete Product: Room component
+class Room : public MapSite {
+public:
+    Room(int roomNumber) : _roomNumber(roomNumber) {}
+
+    // Get a side of the room based on direction
+    MapSite* GetSide(Direction direction) const {
+        return _sides[direction];
+    }
+
+    // Set a side of the room
+    void SetSide(Direction direction, MapSite* site) {
+        _sides[direction] = site;
+    }
+
+    // Get and set the room number
+    int GetRoomNumber() const { return _roomNumber; }
+    void SetRoomNumber(int roomNumber) { _roomNumber = roomNumber; }
+
+    void Enter() override {} // Implementation of interface method
+
+private:
+    MapSite* _sides[4] = {}; // Room's sides (4 directions); non-owning, walls may be shared flyweights
+    int _roomNumber;         // Room identifier
+};
+
+// Concrete Product: Door component connecting two rooms
+class Door : public MapSite {
+public:
+    Door(Room* r1, Room* r2, bool isOpen = false) : _room1(r1), _room2(r2), _isOpen(isOpen) {}
+
+    // Get the room on the other side of the door
+    Room* OtherSideFrom(Room* room) {
+        return (room == _room1) ? _room2 : _room1;
+    }
+
+    // Rooms connected by this door, and its state
+    Room* GetRoom1() const { return _room1; }
+    Room* GetRoom2() const { return _room2; }
+    bool IsOpen() const { return _isOpen; }
+
+    // Attach the door to its rooms (for loaders that create doors before reading them)
+    void Connect(Room* r1, Room* r2, bool isOpen) {
+        _room1 = r1;
+        _room2 = r2;
+        _isOpen = isOpen;
+    }
+
+    void Enter() override {} // Implementation of interface method
+
+private:
+    Room* _room1;  // First connected room
+    Room* _room2;  // Second connected room
+    bool _isOpen;  // Door state
+};
+
+// Concrete Product: Wall component
+class Wall : public MapSite {
+public:
+    Wall() = default;
+    void Enter() override {} // Implementation of interface method
+};
+
+// Flyweight: one shared, stateless instance per wall kind (see Builder.cpp)
+class WallFlyweights {
+public:
+    template <class TWall = Wall>
+    static TWall* Get() {
+        static TWall instance;
+        return &instance;
+    }
+};
+
+// Product: The maze object graph
+class Maze {
+public:
+    Maze() = default;
+
+    // Add a room to the maze
+    void AddRoom(Room* room) {
+        _rooms.push_back(room);
+        _index[room->GetRoomNumber()] = room;
+    }
+
+    // Get a room by number (nullptr if the maze has no such room)
+    Room* RoomNo(int roomNumber) const {
+        auto it = _index.find(roomNumber);
+        return it == _index.end() ? nullptr : it->second;
+    }
+
+    // All rooms, in insertion order
+    const std::vector<Room*>& Rooms() const { return _rooms; }
+
+    // Pre-size for `rooms` rooms (used by loaders that know the count up front)
+    void Reserve(std::size_t rooms) {
+        _rooms.reserve(rooms);
+        _index.reserve(rooms);
+    }
+
+private:
+    std::vector<Room*> _rooms;                // Collection of rooms in the maze
+    std::unordered_map<int, Room*> _index;    // Room number -> room
+};
+
+// Builder: Abstract interface for constructing maze components
+class MazeBuilder
+{
+public:
+    virtual void BuildMaze() { }
+    virtual void BuildRoom(int /*room*/) { }
+    virtual void BuildDoor(int /*roomFrom*/, int /*roomTo*/) { }
+    virtual Maze* GetMaze() { return nullptr; }
+    virtual ~MazeBuilder() = default; // Virtual destructor for polymorphic deletion
+
+protected:
+    MazeBuilder() = default; // Protected constructor to prevent instantiation
+};
+
+// ConcreteBuilder: Implements MazeBuilder to construct a standard maze
+class StandardMazeBuilder : public MazeBuilder {
+public:
+    StandardMazeBuilder() : _currentMaze(nullptr) {}
+
+    void BuildMaze() override {
+        _currentMaze = new Maze();
+    }
+
+    void BuildRoom(int room) override {
+        if (!_currentMaze->RoomNo(room)) {
+            Room* newRoom = new Room(room);
+            _currentMaze->AddRoom(newRoom);
+            // Initialize all sides with the shared wall
+            Wall* wall = WallFlyweights::Get<Wall>();
+            newRoom->SetSide(North, wall);
+            newRoom->SetSide(South, wall);
+            newRoom->SetSide(East, wall);
+            newRoom->SetSide(West, wall);
+        }
+    }
+
+    void BuildDoor(int roomFrom, int roomTo) override {
+        Room* r1 = _currentMaze->RoomNo(roomFrom);
+        Room* r2 = _currentMaze->RoomNo(roomTo);
+        Door* door = new Door(r1, r2);
+
+        // Determine common wall direction and set the door
+        r1->SetSide(CommonWall(r1, r2), door);
+        r2->SetSide(CommonWall(r2, r1), door);
+    }
+
+    Maze* GetMaze() override {
+        return _currentMaze;
+    }
+
+private:
+    // Determines the direction of the common wall between two rooms
+    static Direction CommonWall(Room* r1, Room* r2) {
+        // Simple heuristic: assumes rooms are ordered and adjacent east-west
+        return (r1->GetRoomNumber() < r2->GetRoomNumber()) ? East : West;
+    }
+
+    Maze* _currentMaze;
+};
+
+/*
+    Maze file format
+
+    A maze is stored as fixed-width little-endian records, so it can be used straight from a
+    memory mapping without parsing:
+
+        Header (32 bytes)
+            char[4]  magic       "MAZE"
+            uint32   version     1
+            uint64   roomCount
+            uint64   doorCount
+            uint64   reserved    0
+
+        Room record (20 bytes) x roomCount, sorted by room number
+            int32    number
+            uint32   sides[4]    North, South, East, West
+
+        Door record (12 bytes) x doorCount
+            uint32   room1       index of a room record
+            uint32   room2       index of a room record
+            uint32   flags       bit 0: door is open
+
+    Every side is a tagged 32-bit value (as in CompactMaze): the top 2 bits hold the tag and
+    the low 30 bits the payload.
+
+        EmptySide : nothing set
+        WallSide  : payload is the wall kind (0 = plain wall)
+        DoorSide  : payload is the index of a door record
+        RoomSide  : payload is the index of the room record directly on the other side
+*/
+namespace MazeFile {
+
+enum SideTag : std::uint32_t { EmptySide = 0, WallSide = 1, DoorSide = 2, RoomSide = 3 };
+
+constexpr char Magic[4] = {'M', 'A', 'Z', 'E'};
+constexpr std::uint32_t Version = 1;
+constexpr std::size_t HeaderSize = 32;
+constexpr std::size_t RoomRecordSize = 20;
+constexpr std::size_t DoorRecordSize = 12;
+constexpr std::uint32_t PayloadMask = (1u << 30) - 1;
+constexpr std::uint32_t DoorOpen = 1;
+
+constexpr std::uint32_t MakeSide(SideTag tag, std::uint32_t payload = 0) {
+    return (static_cast<std::uint32_t>(tag) << 30) | (payload & PayloadMask);
+}
+constexpr SideTag TagOf(std::uint32_t side) { return static_cast<SideTag>(side >> 30); }
+constexpr std::uint32_t PayloadOf(std::uint32_t side) { return side & PayloadMask; }
+
+// Little-endian loads and stores, independent of the host byte order
+inline std::uint32_t LoadU32(const unsigned char* p) {
+    return static_cast<std::uint32_t>(p[0]) | static_cast<std::uint32_t>(p[1]) << 8 |
+           static_cast<std::uint32_t>(p[2]) << 16 | static_cast<std::uint32_t>(p[3]) << 24;
+}
+inline std::uint64_t LoadU64(const unsigned char* p) {
+    return static_cast<std::uint64_t>(LoadU32(p)) | static_cast<std::uint64_t>(LoadU32(p + 4)) << 32;
+}
+inline void StoreU32(unsigned char* p, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        p[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+}
+inline void StoreU64(unsigned char* p, std::uint64_t value) {
+    StoreU32(p, static_cast<std::uint32_t>(value));
+    StoreU32(p + 4, static_cast<std::uint32_t>(value >> 32));
+}
+
+// Header: magic, version and record counts; false if `header` is not a maze file header
+inline bool ReadHeader(const unsigned char* header, std::uint64_t& roomCount, std::uint64_t& doorCount) {
+    if (!std::equal(Magic, Magic + 4, header) || LoadU32(header + 4) != Version) {
+        return false;
+    }
+    roomCount = LoadU64(header + 8);
+    doorCount = LoadU64(header + 16);
+    return true;
+}
+
+inline void WriteHeader(unsigned char* header, std::uint64_t roomCount, std::uint64_t doorCount) {
+    std::fill(header, header + HeaderSize, 0);
+    std::copy(Magic, Magic + 4, header);
+    StoreU32(header + 4, Version);
+    StoreU64(header + 8, roomCount);
+    StoreU64(header + 16, doorCount);
+}
+
+// Fixed-size staging buffer: records are encoded in place and flushed in large writes
+class RecordWriter {
+public:
+    explicit RecordWriter(std::ostream& out) : _out(out) {}
+    ~RecordWriter() { Flush(); }
+
+    // Space for the next record of `size` bytes
+    unsigned char* Next(std::size_t size) {
+        if (_used + size > sizeof(_buffer)) {
+            Flush();
+        }
+        unsigned char* record = _buffer + _used;
+        _used += size;
+        return record;
+    }
+
+    void Flush() {
+        _out.write(reinterpret_cast<const char*>(_buffer), static_cast<std::streamsize>(_used));
+        _used = 0;
+    }
+
+private:
+    std::ostream& _out;
+    unsigned char _buffer[1 << 16];
+    std::size_t _used = 0;
+};
+
+// Maximum rooms or doors in one file: side payloads index them with 30 bits
+constexpr std::uint64_t MaxRecords = PayloadMask + 1ull;
+
+// Serializes `maze` to `out`. Returns false, writing nothing, if the maze cannot be stored:
+// more rooms or doors than side payloads can address, two rooms with the same number, or a
+// door or passage leading to a room outside the maze. Also false if the stream failed.
+inline bool Write(std::ostream& out, const Maze& maze) {
+    if (maze.Rooms().size() > MaxRecords) {
+        return false;
+    }
+    std::vector<Room*> rooms = maze.Rooms();
+    std::sort(rooms.begin(), rooms.end(),
+              [](const Room* a, const Room* b) { return a->GetRoomNumber() < b->GetRoomNumber(); });
+
+    std::unordered_map<const Room*, std::uint32_t> roomIndex;
+    roomIndex.reserve(rooms.size());
+    for (std::size_t i = 0; i < rooms.size(); ++i) {
+        if (i > 0 && rooms[i]->GetRoomNumber() == rooms[i - 1]->GetRoomNumber()) {
+            return false; // Room numbers identify rooms in the file
+        }
+        roomIndex.emplace(rooms[i], static_cast<std::uint32_t>(i));
+    }
+    auto inMaze = [&roomIndex](const Room* room) { return roomIndex.find(room) != roomIndex.end(); };
+
+    // Number the doors first so the header is complete up front (and `out` need not be seekable)
+    std::vector<const Door*> doors;
+    std::unordered_map<const Door*, std::uint32_t> doorIndex;
+    for (const Room* room : rooms) {
+        for (int d = North; d <= West; ++d) {
+            MapSite* site = room->GetSide(static_cast<Direction>(d));
+            if (auto* door = dynamic_cast<const Door*>(site)) {
+                if (doorIndex.emplace(door, static_cast<std::uint32_t>(doors.size())).second) {
+                    if (!inMaze(door->GetRoom1()) || !inMaze(door->GetRoom2())) {
+                        return false;
+                    }
+                    doors.push_back(door);
+                }
+            } else if (auto* neighbor = dynamic_cast<const Room*>(site)) {
+                if (!inMaze(neighbor)) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    if (doors.size() > MaxRecords) {
+        return false;
+    }
+
+    RecordWriter writer(out);
+    WriteHeader(writer.Next(HeaderSize), rooms.size(), doors.size());
+
+    for (const Room* room : rooms) {
+        unsigned char* record = writer.Next(RoomRecordSize);
+        StoreU32(record, static_cast<std::uint32_t>(room->GetRoomNumber()));
+        for (int d = North; d <= West; ++d) {
+            MapSite* site = room->GetSide(static_cast<Direction>(d));
+            std::uint32_t side = MakeSide(EmptySide);
+            if (auto* door = dynamic_cast<const Door*>(site)) {
+                side = MakeSide(DoorSide, doorIndex.find(door)->second);
+            } else if (auto* neighbor = dynamic_cast<const Room*>(site)) {
+                side = MakeSide(RoomSide, roomIndex.find(neighbor)->second); // Checked above
+            } else if (site) {
+                side = MakeSide(WallSide);
+            }
+            StoreU32(record + 4 + 4 * d, side);
+        }
+    }
+
+    for (const Door* door : doors) {
+        unsigned char* record = writer.Next(DoorRecordSize);
+        StoreU32(record, roomIndex.find(door->GetRoom1())->second);
+        StoreU32(record + 4, roomIndex.find(door->GetRoom2())->second);
+        StoreU32(record + 8, door->IsOpen() ? DoorOpen : 0);
+    }
+
+    writer.Flush();
+    return static_cast<bool>(out);
+}
+
+// Counterpart of RecordWriter: hands out records straight from a fixed-size read buffer
+class RecordReader {
+public:
+    explicit RecordReader(std::istream& in) : _in(in) {}
+
+    // The next `size` bytes, or nullptr if the stream ends first
+    const unsigned char* Next(std::size_t size) {
+        if (_end - _pos < size) {
+            Refill();
+            if (_end - _pos < size) {
+                return nullptr;
+            }
+        }
+        const unsigned char* record = _buffer + _pos;
+        _pos += size;
+        return record;
+    }
+
+private:
+    void Refill() {
+        std::size_t left = _end - _pos;
+        std::copy(_buffer + _pos, _buffer + _end, _buffer);
+        _in.read(reinterpret_cast<char*>(_buffer + left), static_cast<std::streamsize>(sizeof(_buffer) - left));
+        _pos = 0;
+        _end = left + static_cast<std::size_t>(_in.gcount());
+    }
+
+    std::istream& _in;
+    unsigned char _buffer[1 << 16];
+    std::size_t _pos = 0;
+    std::size_t _end = 0;
+};
+
+// Writes `maze` to the file `path`; returns false if the maze or the file cannot be written
+inline bool Write(const char* path, const Maze& maze) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out || !Write(out, maze)) {
+        return false;
+    }
+    out.close(); // Flushes; a failed flush (e.g. a full disk) only shows here
+    return !out.fail();
+}
+
+} // namespace MazeFile
+
+/*
+    MappedMaze : A maze file used in place, through a read-only memory mapping.
+
+    Nothing is parsed or copied when the file is opened, and no Room/Door/Wall objects are
+    ever built: RoomNo and GetSide return small views that read the records straight from
+    the mapping. Pages are only loaded when they are touched, the maze may be larger than
+    RAM, and processes mapping the same file share one copy in the page cache.
+
+    Room records are sorted by number, so RoomNo is a single index computation when the
+    numbers are contiguous and a binary search otherwise.
+
+    Open only checks the header and that the file is long enough for the records it
+    announces, so it costs the same for any file size. The records themselves are checked
+    where they are used: a view compares each door or room payload it follows against the
+    record count (one compare) and yields a false RoomView or an empty SideView when it is
+    out of range. A corrupt file can give wrong answers (RoomNo may miss rooms whose numbers
+    are out of order) but is never read out of bounds.
+*/
+class MappedMaze {
+public:
+    class RoomView;
+
+    // A room side: a wall, a door, a passage to another room, or nothing
+    class SideView {
+    public:
+        SideView() = default; // Empty side
+
+        bool IsEmpty() const { return MazeFile::TagOf(_side) == MazeFile::EmptySide; }
+        bool IsWall() const { return MazeFile::TagOf(_side) == MazeFile::WallSide; }
+        bool IsDoor() const { return MazeFile::TagOf(_side) == MazeFile::DoorSide; }
+        bool IsRoom() const { return MazeFile::TagOf(_side) == MazeFile::RoomSide; }
+
+        // Door only (false, or a false view, for anything else)
+        bool IsOpen() const {
+            const unsigned char* door = Door();
+            return door && (MazeFile::LoadU32(door + 8) & MazeFile::DoorOpen);
+        }
+        RoomView OtherSideFrom(const RoomView& room) const {
+            const unsigned char* door = Door();
+            if (!door) {
+                return RoomView();
+            }
+            std::uint32_t room1 = MazeFile::LoadU32(door);
+            std::uint32_t room2 = MazeFile::LoadU32(door + 4);
+            return _maze->RoomAt(room.Index() == room1 ? room2 : room1);
+        }
+
+        // Room (open passage) only
+        RoomView GetRoom() const { return IsRoom() ? _maze->RoomAt(MazeFile::PayloadOf(_side)) : RoomView(); }
+
+    private:
+        friend class MappedMaze;
+        SideView(const MappedMaze* maze, std::uint32_t side) : _maze(maze), _side(side) {}
+
+        // The door record, or nullptr if this is not a door or its index is out of range
+        const unsigned char* Door() const {
+            std::uint32_t door = MazeFile::PayloadOf(_side);
+            return IsDoor() && door < _maze->_doorCount ? _maze->_doors + door * MazeFile::DoorRecordSize : nullptr;
+        }
+
+        const MappedMaze* _maze = nullptr;
+        std::uint32_t _side = MazeFile::MakeSide(MazeFile::EmptySide);
+    };
+
+    // A room record; false when RoomNo found no such room (number 0, every side empty)
+    class RoomView {
+    public:
+        RoomView() = default;
+
+        explicit operator bool() const { return _maze != nullptr; }
+
+        int GetRoomNumber() const { return _maze ? static_cast<int>(MazeFile::LoadU32(Record())) : 0; }
+        SideView GetSide(Direction direction) const {
+            return _maze ? SideView(_maze, MazeFile::LoadU32(Record() + 4 + 4 * direction)) : SideView();
+        }
+
+        std::uint32_t Index() const { return _index; }
+
+    private:
+        friend class MappedMaze;
+        RoomView(const MappedMaze* maze, std::uint32_t index) : _maze(maze), _index(index) {} // index < RoomCount()
+        const unsigned char* Record() const { return _maze->_rooms + _index * MazeFile::RoomRecordSize; }
+
+        const MappedMaze* _maze = nullptr;
+        std::uint32_t _index = 0;
+    };
+
+    // Maps `path`; nullptr if it cannot be opened or is not a valid maze file
+    static std::unique_ptr<MappedMaze> Open(const char* path) {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) {
+            return nullptr;
+        }
+        struct stat info {};
+        void* mapping = MAP_FAILED;
+        if (::fstat(fd, &info) == 0 && info.st_size >= static_cast<off_t>(MazeFile::HeaderSize)) {
+            mapping = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        }
+        ::close(fd); // The mapping stays valid without the descriptor
+        if (mapping == MAP_FAILED) {
+            return nullptr;
+        }
+
+        std::unique_ptr<MappedMaze> maze(new MappedMaze(static_cast<const unsigned char*>(mapping),
+                                                        static_cast<std::size_t>(info.st_size)));
+        return maze->Validate() ? std::move(maze) : nullptr;
+    }
+
+    MappedMaze(const MappedMaze&) = delete;
+    MappedMaze& operator=(const MappedMaze&) = delete;
+    ~MappedMaze() { ::munmap(const_cast<unsigned char*>(_data), _size); }
+
+    // Get a room by number (a false view if there is no such room)
+    RoomView RoomNo(int roomNumber) const {
+        if (_roomCount == 0) {
+            return RoomView();
+        }
+        long long slot = static_cast<long long>(roomNumber) - _firstNumber;
+        if (_contiguous) {
+            return (slot >= 0 && slot < static_cast<long long>(_roomCount)) ? RoomView(this, static_cast<std::uint32_t>(slot))
+                                                                             : RoomView();
+        }
+        std::size_t low = 0, high = _roomCount;
+        while (low < high) {
+            std::size_t mid = low + (high - low) / 2;
+            int number = static_cast<int>(MazeFile::LoadU32(_rooms + mid * MazeFile::RoomRecordSize));
+            if (number < roomNumber) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        bool found = low < _roomCount &&
+                     static_cast<int>(MazeFile::LoadU32(_rooms + low * MazeFile::RoomRecordSize)) == roomNumber;
+        return found ? RoomView(this, static_cast<std::uint32_t>(low)) : RoomView();
+    }
+
+    // Room by record index (0 .. RoomCount()-1; a false view otherwise)
+    RoomView RoomAt(std::size_t index) const {
+        return index < _roomCount ? RoomView(this, static_cast<std::uint32_t>(index)) : RoomView();
+    }
+
+    std::size_t RoomCount() const { return _roomCount; }
+    std::size_t DoorCount() const { return _doorCount; }
+
+private:
+    MappedMaze(const unsigned char* data, std::size_t size) : _data(data), _size(size) {}
+
+    bool Validate() {
+        std::uint64_t rooms = 0, doors = 0;
+        if (!MazeFile::ReadHeader(_data, rooms, doors)) {
+            return false;
+        }
+        std::uint64_t available = _size - MazeFile::HeaderSize;
+        if (rooms > available / MazeFile::RoomRecordSize ||
+            doors > (available - rooms * MazeFile::RoomRecordSize) / MazeFile::DoorRecordSize) {
+            return false; // Truncated file
+        }
+        _roomCount = static_cast<std::size_t>(rooms);
+        _doorCount = static_cast<std::size_t>(doors);
+        _rooms = _data + MazeFile::HeaderSize;
+        _doors = _rooms + _roomCount * MazeFile::RoomRecordSize;
+        if (_roomCount > 0) {
+            _firstNumber = static_cast<int>(MazeFile::LoadU32(_rooms));
+            long long last = static_cast<int>(MazeFile::LoadU32(_rooms + (_roomCount - 1) * MazeFile::RoomRecordSize));
+            _contiguous = last - _firstNumber + 1 == static_cast<long long>(_roomCount);
+        }
+        return true;
+    }
+
+    const unsigned char* _data;       // Start of the mapping (the header)
+    std::size_t _size;                // Length of the mapping
+    const unsigned char* _rooms = nullptr;
+    const unsigned char* _doors = nullptr;
+    std::size_t _roomCount = 0;
+    std::size_t _doorCount = 0;
+    long long _firstNumber = 0;       // Number of the first (smallest) room
+    bool _contiguous = false;         // Room numbers are _firstNumber, _firstNumber + 1, ...
+};
+
+/*
+    ConcreteBuilder: "Builds" a maze by mapping a maze file.
+
+    Its product is a MappedMaze rather than a Maze object graph (products of different
+    builders need not share an interface), so GetMaze keeps returning nullptr and the result
+    is fetched with GetMappedMaze.
+*/
+class MappedMazeBuilder : public MazeBuilder {
+public:
+    explicit MappedMazeBuilder(const char* path) : _path(path) {}
+
+    void BuildMaze() override { _maze = MappedMaze::Open(_path); }
+
+    // The mapped maze (nullptr if the file could not be mapped)
+    std::unique_ptr<MappedMaze> GetMappedMaze() { return std::move(_maze); }
+
+private:
+    const char* _path;
+    std::unique_ptr<MappedMaze> _maze;
+};
+
+/*
+    ConcreteBuilder: Builds a Maze object graph by streaming a maze file.
+
+    BuildMaze decodes the records as they come out of a fixed-size read buffer and links the
+    rooms, doors and (flyweight) walls directly; the file is never held in memory as a whole.
+    Every room and door is allocated up front from the header counts, so a side can point at
+    one whose record has not been read yet; door records then connect their rooms. GetMaze
+    returns nullptr if the stream is not a valid maze file (including unsorted or duplicate
+    room numbers).
+*/
+class StreamMazeBuilder : public MazeBuilder {
+public:
+    explicit StreamMazeBuilder(std::istream& in) : _in(in), _maze(nullptr) {}
+
+    void BuildMaze() override {
+        _maze = nullptr;
+        MazeFile::RecordReader reader(_in);
+        const unsigned char* header = reader.Next(MazeFile::HeaderSize);
+        std::uint64_t roomCount = 0, doorCount = 0;
+        if (!header || !MazeFile::ReadHeader(header, roomCount, doorCount) ||
+            roomCount > MazeFile::MaxRecords || doorCount > MazeFile::MaxRecords) {
+            return;
+        }
+
+        std::vector<Room*> rooms(static_cast<std::size_t>(roomCount));
+        std::vector<Door*> doors(static_cast<std::size_t>(doorCount));
+        for (Room*& room : rooms) {
+            room = new Room(0);
+        }
+        for (Door*& door : doors) {
+            door = new Door(nullptr, nullptr);
+        }
+
+        bool valid = true;
+        for (std::uint64_t i = 0; valid && i < roomCount; ++i) {
+            const unsigned char* record = reader.Next(MazeFile::RoomRecordSize);
+            int number = record ? static_cast<int>(MazeFile::LoadU32(record)) : 0;
+            if (!record || (i > 0 && number <= rooms[i - 1]->GetRoomNumber())) {
+                valid = false; // Truncated, or rooms not sorted by unique number
+                break;
+            }
+            Room* room = rooms[i];
+            room->SetRoomNumber(number);
+            for (int d = North; d <= West; ++d) {
+                std::uint32_t side = MazeFile::LoadU32(record + 4 + 4 * d);
+                std::uint32_t target = MazeFile::PayloadOf(side);
+                switch (MazeFile::TagOf(side)) {
+                case MazeFile::EmptySide:
+                    break;
+                case MazeFile::WallSide:
+                    room->SetSide(static_cast<Direction>(d), WallFlyweights::Get<Wall>());
+                    break;
+                case MazeFile::DoorSide:
+                    valid = valid && target < doorCount;
+                    room->SetSide(static_cast<Direction>(d), valid ? doors[target] : nullptr);
+                    break;
+                case MazeFile::RoomSide:
+                    valid = valid && target < roomCount;
+                    room->SetSide(static_cast<Direction>(d), valid ? rooms[target] : nullptr);
+                    break;
+                }
+            }
+        }
+
+        for (std::uint64_t i = 0; valid && i < doorCount; ++i) {
+            const unsigned char* record = reader.Next(MazeFile::DoorRecordSize);
+            std::uint32_t room1 = record ? MazeFile::LoadU32(record) : 0;
+            std::uint32_t room2 = record ? MazeFile::LoadU32(record + 4) : 0;
+            if (!record || room1 >= roomCount || room2 >= roomCount) {
+                valid = false;
+                break;
+            }
+            bool isOpen = (MazeFile::LoadU32(record + 8) & MazeFile::DoorOpen) != 0;
+            doors[i]->Connect(rooms[room1], rooms[room2], isOpen);
+        }
+
+        if (!valid) {
+            for (Door* door : doors) {
+                delete door;
+            }
+            for (Room* room : rooms) {
+                delete room;
+            }
+            return;
+        }
+
+        _maze = new Maze();
+        _maze->Reserve(rooms.size());
+        for (Room* room : rooms) {
+            _maze->AddRoom(room);
+        }
+    }
+
+    Maze* GetMaze() override { return _maze; }
+
+private:
+    std::istream& _in;
+    Maze* _maze;
+};
+
+int main() {
+    // Build a corridor maze once and store it
+    StandardMazeBuilder builder;
+    builder.BuildMaze();
+    for (int n = 1; n <= 1000; ++n) {
+        builder.BuildRoom(n);
+    }
+    for (int n = 1; n < 1000; ++n) {
+        builder.BuildDoor(n, n + 1);
+    }
+    const char* path = "maze.bin";
+    if (!MazeFile::Write(path, *builder.GetMaze())) {
+        std::cerr << "Cannot write " << path << std::endl;
+        return 1;
+    }
+
+    // Later (or in another process): use it in place
+    MappedMazeBuilder mappedBuilder(path);
+    mappedBuilder.BuildMaze();
+    std::unique_ptr<MappedMaze> maze = mappedBuilder.GetMappedMaze();
+    if (!maze) {
+        std::cerr << "Cannot map " << path << std::endl;
+        return 1;
+    }
+
+    MappedMaze::RoomView room = maze->RoomNo(1);
+    int steps = 0;
+    while (room.GetSide(East).IsDoor()) {
+        room = room.GetSide(East).OtherSideFrom(room);
+        ++steps;
+    }
+    std::cout << "Rooms: " << maze->RoomCount() << ", walked east " << steps << " doors to room "
+              << room.GetRoomNumber() << std::endl;
+
+    maze.reset();
+
+    // Or load it back as an object graph, streaming through a builder
+    std::ifstream file(path, std::ios::binary);
+    StreamMazeBuilder streamBuilder(file);
+    streamBuilder.BuildMaze();
+    Maze* loaded = streamBuilder.GetMaze();
+    std::cout << "Loaded " << (loaded ? loaded->Rooms().size() : 0) << " rooms from " << path << std::endl;
+    file.close();
+    std::remove(path);
+
+    // Round trip of a larger maze through memory, timing the load
+    StandardMazeBuilder bigBuilder;
+    bigBuilder.BuildMaze();
+    const int bigRooms = 1000000;
+    for (int n = 1; n <= bigRooms; ++n) {
+        bigBuilder.BuildRoom(n);
+    }
+    for (int n = 1; n < bigRooms; ++n) {
+        bigBuilder.BuildDoor(n, n + 1);
+    }
+    std::ostringstream out;
+    MazeFile::Write(out, *bigBuilder.GetMaze());
+    const std::string bytes = out.str();
+
+    std::istringstream in(bytes);
+    StreamMazeBuilder bigLoader(in);
+    auto start = std::chrono::steady_clock::now();
+    bigLoader.BuildMaze();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ostringstream again;
+    MazeFile::Write(again, *bigLoader.GetMaze());
+    std::cout << "Loaded " << bytes.size() / (1024 * 1024) << " MiB in " << seconds * 1000 << " ms ("
+              << bytes.size() / seconds / (1024 * 1024) << " MiB/s), round trip "
+              << (again.str() == bytes ? "identical" : "DIFFERENT") << std::endl;
+    return 0;
+}
@@ -1,6 +1,10 @@
 #include <iostream>
+#include <cstdlib>
+#include <new>
 #include <vector>
 #include <memory> // For potential smart pointer use
+#include <typeinfo>
+#include <unordered_map>
 
 /*
     Intent : Specify the kinds of objects to create using a prototypical instance, and create new objects by copying this prototype.
@@ -36,6 +40,20 @@ public:
     virtual void Enter() = 0;
     virtual MapSite* Clone() const = 0;  // Prototype method
     virtual ~MapSite() = default;
+
+    // Pool that currently has this object handed out, or null (see PooledMazePrototypeFactory)
+    const void* IssuedBy() const { return _issuedBy.pool; }
+    void SetIssuedBy(const void* pool) { _issuedBy.pool = pool; }
+
+private:
+    // Not copied: a clone is not handed out by anyone's pool
+    struct PoolTag {
+        PoolTag() = default;
+        PoolTag(const PoolTag&) {}
+        PoolTag& operator=(const PoolTag&) { return *this; }
+        const void* pool = nullptr;
+    };
+    PoolTag _issuedBy;
 };
 
 // Concrete Prototype: Room component with deep copy
@@ -58,7 +76,26 @@ public:
     // Clone method using copy constructor
     Room* Clone() const override { return new Room(*this); }
 
+    // Shallow copy: same number, sides shared with this room (used by copy-on-write mazes
+    // and MazeCloner). Subclasses override it to keep their dynamic type.
+    virtual Room* CloneShallow() const {
+        Room* room = new Room(_roomNumber);
+        for (int i = 0; i < 4; ++i) {
+            room->_sides[i] = _sides[i];
+        }
+        return room;
+    }
+
+    // Re-initialize a recycled room: new number, no sides
+    void Initialize(int number) {
+        _roomNumber = number;
+        for (auto& side : _sides) {
+            side = nullptr;
+        }
+    }
+
     void SetRoomNumber(int number) { _roomNumber = number; }
+    int GetRoomNumber() const { return _roomNumber; }
     MapSite* GetSide(Direction direction) const { return _sides[direction]; }
     
     void SetSide(Direction direction, MapSite* site) {
@@ -68,7 +105,7 @@ public:
     void Enter() override {}
 
 private:
-    MapSite* _sides[4] = {};
+    MapSite* _sides[4] = {}; // Non-owning; walls may be shared flyweights
     int _roomNumber;
 };
 
@@ -93,6 +130,9 @@ public:
         return _room1 == r ? _room2 : _room1;
     }
 
+    Room* GetRoom1() const { return _room1; }
+    Room* GetRoom2() const { return _room2; }
+
 private:
     Room* _room1 = nullptr;
     Room* _room2 = nullptr;
@@ -105,34 +145,243 @@ public:
     Wall(const Wall&) = default;
     Wall* Clone() const override { return new Wall(*this); }
     void Enter() override {}
+
+    // True for shared flyweight instances, which must never be deleted or recycled
+    virtual bool IsFlyweight() const { return false; }
+};
+
+// Concrete Prototype: Wall variant used by bombed mazes
+class BombedWall : public Wall {
+public:
+    BombedWall() = default;
+    BombedWall(const BombedWall&) = default;
+    BombedWall* Clone() const override { return new BombedWall(*this); }
+    void Enter() override {}
+};
+
+/*
+    Flyweight Prototype: Walls carry no intrinsic state, so a single shared instance per wall
+    kind can stand in for every wall side of every room. Cloning a shared wall returns the
+    same instance, which keeps it shared through Room and Maze deep copies. Rooms only point
+    at these instances (non-owning) and must never delete them.
+*/
+template <class TWall>
+class SharedWall : public TWall {
+public:
+    SharedWall* Clone() const override { return const_cast<SharedWall*>(this); }
+    bool IsFlyweight() const override { return true; }
+};
+
+class WallFlyweights {
+public:
+    template <class TWall = Wall>
+    static SharedWall<TWall>* Get() {
+        static SharedWall<TWall> instance; // Constructed once, on first use (thread-safe since C++11)
+        return &instance;
+    }
 };
 
-// Concrete Prototype: Maze container with deep copy
+/*
+    MazeCloner : Graph-preserving deep copy.
+
+    Cloning every room on its own (Room's copy constructor) clones a door once per room that
+    uses it, and the copies still point at the original rooms. MazeCloner instead keeps an
+    identity map (original -> clone) for the whole graph: every room, door and wall is cloned
+    exactly once, sharing between rooms is kept, and each cloned door is re-initialized with
+    the cloned rooms. Rooms are processed from an explicit worklist, so long corridors do not
+    recurse.
+*/
+class MazeCloner {
+public:
+    // Clone of `room` (created on first request; its sides are filled in by Run)
+    Room* CloneRoom(const Room* room) {
+        if (!room) {
+            return nullptr;
+        }
+        auto it = _clones.find(room);
+        if (it != _clones.end()) {
+            return static_cast<Room*>(it->second);
+        }
+        Room* clone = room->CloneShallow();
+        _clones.emplace(room, clone);
+        _pending.push_back(room);
+        return clone;
+    }
+
+    // Make references to `original` resolve to an existing clone
+    void Alias(const Room* original, Room* clone) { _clones.emplace(original, clone); }
+
+    // Clone the sides of every room requested so far (and of the rooms they lead to)
+    void Run() {
+        while (!_pending.empty()) {
+            const Room* original = _pending.back();
+            _pending.pop_back();
+            Room* clone = static_cast<Room*>(_clones[original]);
+            for (int d = North; d <= West; ++d) {
+                Direction direction = static_cast<Direction>(d);
+                clone->SetSide(direction, CloneSite(original->GetSide(direction)));
+            }
+        }
+    }
+
+private:
+    MapSite* CloneSite(const MapSite* site) {
+        if (!site) {
+            return nullptr;
+        }
+        auto it = _clones.find(site);
+        if (it != _clones.end()) {
+            return it->second;
+        }
+        if (auto* room = dynamic_cast<const Room*>(site)) {
+            return CloneRoom(room);
+        }
+        MapSite* clone = site->Clone();
+        _clones.emplace(site, clone);
+        if (auto* door = dynamic_cast<const Door*>(site)) {
+            static_cast<Door*>(clone)->Initialize(CloneRoom(door->GetRoom1()), CloneRoom(door->GetRoom2()));
+        }
+        return clone;
+    }
+
+    std::unordered_map<const MapSite*, MapSite*> _clones; // Identity map: original -> clone
+    std::vector<const Room*> _pending;                     // Cloned rooms whose sides are not done yet
+};
+
+/*
+    Concrete Prototype: Maze container with deep copy and copy-on-write clones.
+
+    Clone() deep-copies every room. CloneShared() is the copy-on-write variant: the clone
+    shares the prototype's room table, which makes it O(1), and a maze only makes a private
+    (shallow) copy of a room the first time that room is modified through Maze::SetSide or
+    Maze::EditRoomNo. Rooms returned by RoomNo may therefore be shared with other mazes and
+    must be treated as read-only.
+
+    Ownership is tracked per room, not per table: rooms are only ever appended, so the rooms
+    present when a maze takes part in CloneShared (as source or clone) form a prefix of its
+    table that other mazes may reference, for good. Only rooms past that prefix, added by
+    this maze alone, are modified in place. Copying the table on AddRoom does not change
+    that, since the copy still points at the shared rooms.
+
+    Private room copies share their untouched sides with the prototype, so their doors still
+    point at the prototype's rooms. Cross doors through Maze::OtherSideFrom, which matches the
+    door's rooms by number and returns this maze's version of the room on the other side.
+*/
 class Maze {
 public:
-    Maze() = default;
+    Maze() : _rooms(std::make_shared<std::vector<Room*>>()) {}
     
-    // Deep copy constructor
-    Maze(const Maze& other) {
-        for (Room* room : other._rooms) {
-            _rooms.push_back(room->Clone());
+    // Deep copy constructor: clones the whole room/door graph in one pass
+    Maze(const Maze& other) : Maze() {
+        MazeCloner cloner;
+        _rooms->reserve(other._rooms->size());
+        for (std::size_t i = 0; i < other._rooms->size(); ++i) {
+            const Room* original = (*other._rooms)[i];
+            const Room* room = other.Resolve(original);
+            _rooms->push_back(cloner.CloneRoom(room));
+            if (room != original) {
+                // Doors of copied-on-write rooms still lead to the shared original: map it to
+                // the same clone
+                cloner.Alias(original, _rooms->back());
+            }
         }
+        cloner.Run();
     }
 
     Maze* Clone() const { return new Maze(*this); }
+
+    // Copy-on-write clone: shares the room table (and any private copies) with this maze
+    Maze* CloneShared() const {
+        Maze* maze = new Maze;
+        maze->_rooms = _rooms;
+        maze->_private = _private; // O(modified rooms), not O(rooms)
+        _sharedRooms = maze->_sharedRooms = _rooms->size(); // Both sides stop editing these in place
+        return maze;
+    }
     
-    void AddRoom(Room* room) { _rooms.push_back(room); }
-    Room* RoomNo(int roomNumber) const { return _rooms[roomNumber]; }
+    void AddRoom(Room* room) {
+        if (_rooms.use_count() > 1) {
+            // Structural change: take a private copy of the table (room pointers only)
+            _rooms = std::make_shared<std::vector<Room*>>(*_rooms);
+        }
+        _rooms->push_back(room);
+    }
+
+    // Read-only access; the room may be shared with other mazes
+    Room* RoomNo(int roomNumber) const { return Resolve((*_rooms)[roomNumber]); }
+
+    // Access for modification: materializes a private copy of a shared room first
+    Room* EditRoomNo(int roomNumber) {
+        Room* original = (*_rooms)[roomNumber];
+        auto it = _private.find(original);
+        if (it != _private.end()) {
+            if (it->second.use_count() > 1) {
+                it->second.reset(it->second->CloneShallow()); // Still shared with another clone
+            }
+            return it->second.get();
+        }
+        if (static_cast<std::size_t>(roomNumber) >= _sharedRooms) {
+            return original; // Added by this maze alone: modify in place
+        }
+        Room* room = original->CloneShallow();
+        _private.emplace(original, std::shared_ptr<Room>(room));
+        return room;
+    }
+
+    // This maze's version of the room on the other side of `door` from `room`. Rooms are
+    // matched by number, since the door may still point at rooms this maze has copied.
+    Room* OtherSideFrom(const Door* door, const Room* room) const {
+        Room* room1 = door->GetRoom1();
+        bool fromRoom1 = room1 && room && room1->GetRoomNumber() == room->GetRoomNumber();
+        return Resolve(fromRoom1 ? door->GetRoom2() : room1);
+    }
+
+    void SetSide(int roomNumber, Direction direction, MapSite* site) {
+        EditRoomNo(roomNumber)->SetSide(direction, site);
+    }
+
+    std::size_t RoomCount() const { return _rooms->size(); }
+
+    // Forget every room (without deleting them) so the maze can be reused; keeps the room
+    // table's capacity unless a copy-on-write clone still shares it
+    void Clear() {
+        if (_rooms.use_count() > 1) {
+            _rooms = std::make_shared<std::vector<Room*>>();
+        } else {
+            _rooms->clear();
+        }
+        _private.clear();
+        _sharedRooms = 0;
+    }
+
+    // True if the table room at `roomNumber` belongs to this maze alone: it is neither shared
+    // with a copy-on-write clone or prototype nor replaced by a private copy
+    bool OwnsRoom(int roomNumber) const {
+        return static_cast<std::size_t>(roomNumber) >= _sharedRooms && !_private.count((*_rooms)[roomNumber]);
+    }
 
 private:
-    std::vector<Room*> _rooms;
+    // This maze's version of a table room: its private copy, if it has one
+    Room* Resolve(const Room* original) const {
+        if (!_private.empty()) {
+            auto it = _private.find(original);
+            if (it != _private.end()) {
+                return it->second.get();
+            }
+        }
+        return const_cast<Room*>(original);
+    }
+
+    std::shared_ptr<std::vector<Room*>> _rooms;                      // Room table, shared with copy-on-write clones
+    std::unordered_map<const Room*, std::shared_ptr<Room>> _private; // Rooms copied on write, by shared original
+    mutable std::size_t _sharedRooms = 0;                    // Leading table rooms other mazes may reference
 };
 
 // Factories
 class MazeFactory {
 public:
     virtual Maze* MakeMaze() const { return new Maze; }
-    virtual Wall* MakeWall() const { return new Wall; }
+    virtual Wall* MakeWall() const { return WallFlyweights::Get<Wall>(); } // Shared, never deleted
     virtual Room* MakeRoom(int n) const { return new Room(n); }
     virtual Door* MakeDoor(Room* r1, Room* r2) const { return new Door(r1, r2); }
     virtual ~MazeFactory() = default;
@@ -143,10 +392,13 @@ public:
 // Prototype Factory
 class MazePrototypeFactory : public MazeFactory {
 public:
-    MazePrototypeFactory(Maze* m, Wall* w, Room* r, Door* d)
-        : _prototypeMaze(m), _prototypeWall(w), _prototypeRoom(r), _prototypeDoor(d) {}
+    // With copyOnWrite, MakeMaze shares the prototype maze's rooms instead of deep-copying them
+    MazePrototypeFactory(Maze* m, Wall* w, Room* r, Door* d, bool copyOnWrite = false)
+        : _prototypeMaze(m), _prototypeWall(w), _prototypeRoom(r), _prototypeDoor(d), _copyOnWrite(copyOnWrite) {}
 
-    Maze* MakeMaze() const override { return _prototypeMaze->Clone(); }
+    Maze* MakeMaze() const override {
+        return _copyOnWrite ? _prototypeMaze->CloneShared() : _prototypeMaze->Clone();
+    }
     
     Wall* MakeWall() const override { return _prototypeWall->Clone(); }
     
@@ -167,8 +419,149 @@ private:
     Wall* _prototypeWall;
     Room* _prototypeRoom;
     Door* _prototypeDoor;
+    bool _copyOnWrite;
 };
 
+/*
+    Pooled Prototype Factory: recycles released mazes, rooms, doors and walls.
+
+    Instead of cloning (and allocating) a new object for every MakeRoom/MakeDoor/MakeWall, the
+    factory first takes a previously released object of the same type off its free list and
+    re-initializes it (Room::Initialize, Door::Initialize). Release(Maze*) hands a whole maze
+    back: its rooms and their sides go to the free lists, and the emptied maze is kept for the
+    next MakeMaze when the prototype maze is empty (otherwise MakeMaze has to clone anyway).
+
+    The pool is the single owner of what it recycles. Every object it hands out is tagged with
+    the pool (MapSite::IssuedBy), and Release only takes back objects carrying that tag, from
+    rooms the maze owns alone (Maze::OwnsRoom). Rooms shared with a prototype, private copies
+    (freed by the maze itself) and components from elsewhere are left alone. Taking an object
+    back clears its tag, so a door seen from both of its rooms is pooled once. Once the free
+    lists are warm, a build/Release cycle does not allocate at all.
+
+    The free lists are not locked. Give every worker thread its own factory: objects are then
+    recycled thread-locally and no allocator lock is touched in the steady state.
+*/
+class PooledMazePrototypeFactory : public MazePrototypeFactory {
+public:
+    PooledMazePrototypeFactory(Maze* m, Wall* w, Room* r, Door* d, std::size_t maxPooled = 4096)
+        : MazePrototypeFactory(m, w, r, d), _maze(m), _room(r), _door(d), _wall(w), _maxPooled(maxPooled) {}
+
+    ~PooledMazePrototypeFactory() override {
+        for (Maze* maze : _freeMazes) delete maze;
+        for (Room* room : _freeRooms) delete room;
+        for (Door* door : _freeDoors) delete door;
+        for (Wall* wall : _freeWalls) delete wall;
+    }
+
+    Maze* MakeMaze() const override {
+        if (_freeMazes.empty() || _maze->RoomCount() != 0) {
+            return MazePrototypeFactory::MakeMaze();
+        }
+        Maze* maze = _freeMazes.back();
+        _freeMazes.pop_back();
+        return maze;
+    }
+
+    Room* MakeRoom(int n) const override {
+        if (_freeRooms.empty()) {
+            return Issue(MazePrototypeFactory::MakeRoom(n));
+        }
+        Room* room = Reissue(_freeRooms);
+        room->Initialize(n);
+        return room;
+    }
+
+    Door* MakeDoor(Room* r1, Room* r2) const override {
+        if (_freeDoors.empty()) {
+            return Issue(MazePrototypeFactory::MakeDoor(r1, r2));
+        }
+        Door* door = Reissue(_freeDoors);
+        door->Initialize(r1, r2);
+        return door;
+    }
+
+    Wall* MakeWall() const override {
+        if (_freeWalls.empty()) {
+            Wall* wall = MazePrototypeFactory::MakeWall();
+            return wall->IsFlyweight() ? wall : Issue(wall);
+        }
+        return Reissue(_freeWalls);
+    }
+
+    // Hand back a maze built by this factory; the maze is recycled or deleted. Only the pool's
+    // own objects, reached from rooms the maze owns alone, are recycled; everything else stays
+    // with its owner.
+    void Release(Maze* maze) {
+        for (std::size_t i = 0; i < maze->RoomCount(); ++i) {
+            if (!maze->OwnsRoom(static_cast<int>(i))) {
+                continue;
+            }
+            Room* room = maze->RoomNo(static_cast<int>(i));
+            for (int d = North; d <= West; ++d) {
+                MapSite* side = room->GetSide(static_cast<Direction>(d));
+                if (side && side->IssuedBy() == this) {
+                    ReleaseSite(side);
+                }
+            }
+            Recycle(room, _room, _freeRooms);
+        }
+        if (_freeMazes.size() < _maxPooled) {
+            maze->Clear();
+            _freeMazes.push_back(maze);
+        } else {
+            delete maze;
+        }
+    }
+
+private:
+    void ReleaseSite(MapSite* site) {
+        if (auto* door = dynamic_cast<Door*>(site)) {
+            Recycle(door, _door, _freeDoors);
+        } else if (auto* wall = dynamic_cast<Wall*>(site)) {
+            Recycle(wall, _wall, _freeWalls);
+        }
+    }
+
+    // Tag a freshly allocated object as handed out by this pool
+    template <class T>
+    T* Issue(T* object) const {
+        object->SetIssuedBy(this);
+        return object;
+    }
+
+    // Hand out a pooled object again (no allocation)
+    template <class T>
+    T* Reissue(std::vector<T*>& freeList) const {
+        T* object = freeList.back();
+        freeList.pop_back();
+        return Issue(object);
+    }
+
+    // Take back one of the pool's handed-out objects; only objects of the prototype's exact
+    // type can stand in for its clones
+    template <class T>
+    void Recycle(T* object, const T* prototype, std::vector<T*>& freeList) const {
+        if (object->IssuedBy() != this) {
+            return; // Not handed out by this pool, or already back in it
+        }
+        object->SetIssuedBy(nullptr);
+        if (freeList.size() < _maxPooled && typeid(*object) == typeid(*prototype)) {
+            freeList.push_back(object);
+        } else {
+            delete object;
+        }
+    }
+
+    const Maze* _maze;
+    const Room* _room;
+    const Door* _door;
+    const Wall* _wall;
+    std::size_t _maxPooled;              // Cap per free list, so a burst does not pin memory
+    mutable std::vector<Maze*> _freeMazes;
+    mutable std::vector<Room*> _freeRooms;
+    mutable std::vector<Door*> _freeDoors;
+    mutable std::vector<Wall*> _freeWalls;
+};
 
 /* Key Prototype Pattern Roles:
     - Prototype (MapSite): Declares clone interface
@@ -177,6 +570,19 @@ private:
     - Prototype Factory: Manages prototype instances and cloning
 */
 
+// Counts heap allocations, so main can check that warm pooled rebuilds do not allocate
+static std::size_t allocationCount = 0;
+
+void* operator new(std::size_t size) {
+    ++allocationCount;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
 class MazeGame 
 {
 public:
@@ -204,8 +610,7 @@ public:
 };
 int main() 
 {
-    // Create prototype instances
-    Wall basicWall;
+    // Create prototype instances (the wall prototype is the shared flyweight)
     Room basicRoom;
     Door basicDoor;
     Maze basicMaze;
@@ -213,7 +618,7 @@ int main()
     // Configure factory with prototypes
     MazePrototypeFactory factory(
         &basicMaze, 
-        &basicWall,
+        WallFlyweights::Get<Wall>(),
         &basicRoom,
         &basicDoor
     );
@@ -221,6 +626,35 @@ int main()
     // Build maze using prototypes
     MazeGame game;
     Maze* maze = game.CreateMaze(factory);
+
+    // One template maze per process, one copy-on-write clone per game session
+    MazePrototypeFactory sessionFactory(maze, WallFlyweights::Get<Wall>(), &basicRoom, &basicDoor, true);
+    Maze* session = sessionFactory.MakeMaze(); // O(1): shares every room with `maze`
+    session->SetSide(0, North, WallFlyweights::Get<BombedWall>()); // Copies room 0 only
+
+    // A session that adds rooms of its own still copies the template's rooms before editing them
+    Maze* bigSession = game.CreateMaze(sessionFactory); // Rooms 0-1 shared, 2-3 its own
+    bigSession->SetSide(1, South, WallFlyweights::Get<BombedWall>());
+    bigSession->SetSide(2, North, WallFlyweights::Get<BombedWall>()); // Edited in place
+    bool templateIntact = maze->RoomNo(0)->GetSide(North) == WallFlyweights::Get<Wall>() &&
+                          maze->RoomNo(1)->GetSide(South) == WallFlyweights::Get<Wall>();
+    std::cout << "Template maze " << (templateIntact ? "unchanged" : "MODIFIED") << " by its sessions" << std::endl;
+
+    // Walking through a door of an edited room and back leads to the session's copy of it
+    Room* start = session->RoomNo(0);
+    Door* door = static_cast<Door*>(start->GetSide(East));
+    Room* back = session->OtherSideFrom(door, session->OtherSideFrom(door, start));
+    std::cout << "Door walk " << (back == start && back->GetSide(North) == WallFlyweights::Get<BombedWall>()
+                                      ? "returns to" : "LEAVES") << " the session's room" << std::endl;
+
+    // Servers that build and tear down many small mazes recycle their components
+    PooledMazePrototypeFactory pooledFactory(&basicMaze, WallFlyweights::Get<Wall>(), &basicRoom, &basicDoor);
+    pooledFactory.Release(game.CreateMaze(pooledFactory)); // Warms the free lists
+    std::size_t allocationsBefore = allocationCount;
+    for (int i = 0; i < 1000; ++i) {
+        pooledFactory.Release(game.CreateMaze(pooledFactory)); // Maze, rooms and doors all recycled
+    }
+    std::cout << "Pooled rebuilds: " << allocationCount - allocationsBefore << " allocations in 1000 mazes" << std::endl;
     
     return 0;
 }
@@ -1,4 +1,14 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 /*
     Intent : Ensure a class only has one instance, and provide a global point of access to it.
@@ -138,29 +148,348 @@ Singleton* Singleton::Instance ()
     return _instance;
 }*/
 
+/*
+    Thread-safe lazy Singleton
+
+    The plain "if (_instance == 0) _instance = new T" check above is a data race when several
+    threads ask for the instance at the same time: more than one of them can see 0 and
+    construct its own instance. Two reusable ways to make Instance() safe:
+
+    1. LazySingleton<T> : double-checked locking over an atomic pointer. The steady-state fast
+       path is a single acquire load; the mutex is only taken while the instance does not exist
+       yet, and the second check under the lock guarantees a single construction. The release
+       store publishes the fully constructed object to the acquire loads of other threads.
+
+    2. MeyersSingleton<T> : a function-local static. C++11 guarantees that its initialization
+       runs exactly once even under concurrent calls; the compiler emits the same kind of
+       guard-variable check on every call.
+
+    MutexSingleton<T> takes the lock on every call and only exists as a baseline for the
+    benchmark in main().
+
+    Classes with a protected constructor grant access with "friend class LazySingleton<T>;".
+*/
+template <class T>
+class LazySingleton 
+{
+    public:
+        static T* Instance()
+        {
+            T* instance = _instance.load(std::memory_order_acquire); // Fast path: no lock
+            if (instance == nullptr) 
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                instance = _instance.load(std::memory_order_relaxed); // Second check under the lock
+                if (instance == nullptr) 
+                {
+                    instance = new T;
+                    _instance.store(instance, std::memory_order_release);
+                }
+            }
+            return instance;
+        }
+    private:
+        static std::atomic<T*> _instance;
+        static std::mutex _mutex;
+};
+
+template <class T> std::atomic<T*> LazySingleton<T>::_instance{nullptr};
+template <class T> std::mutex LazySingleton<T>::_mutex;
+
+template <class T>
+class MeyersSingleton 
+{
+    public:
+        static T* Instance()
+        {
+            static T instance; // Initialized once, thread-safe since C++11
+            return &instance;
+        }
+};
+
+template <class T>
+class MutexSingleton 
+{
+    public:
+        static T* Instance()
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_instance == nullptr) 
+            {
+                _instance = new T;
+            }
+            return _instance;
+        }
+    private:
+        static T* _instance;
+        static std::mutex _mutex;
+};
+
+template <class T> T* MutexSingleton<T>::_instance = nullptr;
+template <class T> std::mutex MutexSingleton<T>::_mutex;
+
+/*
+    Registry of singletons
+
+    The registry sketched above keeps NameSingletonPair entries in a list, so every Lookup is a
+    linear scan with a string compare per entry. SingletonRegistry<T> instead keeps an
+    open-addressing hash table keyed by the 64-bit FNV-1a hash of the name:
+
+    - Names are hashed at compile time when they are constants: HashedName is a literal type,
+      so "constexpr HashedName kBombed{"bombed"}" costs nothing at run time. Names only known
+      at run time (getenv) are hashed once per call.
+
+    - Lookups take no locks. The table is immutable once published; Register copies it, adds
+      the entry and swaps the new table in with a release store (RCU style), and readers pick
+      up whichever table is current with one acquire load. Replaced tables are kept until the
+      registry is destroyed, because a reader may still be probing one; registrations are rare
+      (typically once per class at startup), so this costs little memory.
+
+    - Registration is safe from static initializers in any translation unit: the registry is a
+      function-local static, constructed on first use, and writers are serialized by a mutex.
+*/
+constexpr std::uint64_t HashName(const char* name)
+{
+    std::uint64_t hash = 14695981039346656037ull; // FNV-1a offset basis
+    for (; *name; ++name) 
+    {
+        hash ^= static_cast<unsigned char>(*name);
+        hash *= 1099511628211ull; // FNV-1a prime
+    }
+    return hash;
+}
+
+struct HashedName 
+{
+    constexpr HashedName(const char* n) : name(n ? n : ""), hash(HashName(n ? n : "")) {}
+    const char* name;
+    std::uint64_t hash;
+};
+
+template <class T>
+class SingletonRegistry 
+{
+    public:
+        static SingletonRegistry& Instance()
+        {
+            static SingletonRegistry registry; // Constructed on first use, even during static initialization
+            return registry;
+        }
+
+        // Register (or replace) the singleton known under `name`
+        void Register(HashedName name, T* instance)
+        {
+            std::lock_guard<std::mutex> lock(_writeMutex);
+            const Table* current = _table.load(std::memory_order_relaxed);
+            std::size_t count = (current ? current->size : 0) + 1;
+            std::size_t capacity = 8;
+            while (capacity < 2 * count) 
+            {
+                capacity *= 2;
+            }
+
+            auto next = std::make_unique<Table>(capacity);
+            if (current) 
+            {
+                for (const Entry& entry : current->entries) 
+                {
+                    if (entry.instance && !Matches(entry, name)) 
+                    {
+                        next->Insert(entry);
+                    }
+                }
+            }
+            next->Insert(Entry{name.hash, name.name, instance});
+
+            _table.store(next.get(), std::memory_order_release);
+            _tables.push_back(std::move(next)); // Old tables stay alive for concurrent readers
+        }
+
+        // Singleton registered under `name`, or nullptr; lock-free
+        T* Lookup(HashedName name) const
+        {
+            const Table* table = _table.load(std::memory_order_acquire);
+            if (table == nullptr) 
+            {
+                return nullptr;
+            }
+            for (std::size_t i = name.hash & table->mask; ; i = (i + 1) & table->mask) 
+            {
+                const Entry& entry = table->entries[i];
+                if (entry.instance == nullptr || Matches(entry, name)) 
+                {
+                    return entry.instance;
+                }
+            }
+        }
+
+    private:
+        struct Entry 
+        {
+            std::uint64_t hash = 0;
+            std::string name;
+            T* instance = nullptr; // nullptr marks an empty slot
+        };
+
+        struct Table 
+        {
+            explicit Table(std::size_t capacity) : entries(capacity), mask(capacity - 1) {}
+
+            void Insert(const Entry& entry)
+            {
+                std::size_t i = entry.hash & mask;
+                while (entries[i].instance != nullptr) 
+                {
+                    i = (i + 1) & mask;
+                }
+                entries[i] = entry;
+                ++size;
+            }
+
+            std::vector<Entry> entries; // Power-of-two sized, at most half full
+            std::size_t mask;
+            std::size_t size = 0;       // Occupied entries
+        };
+
+        static bool Matches(const Entry& entry, HashedName name)
+        {
+            return entry.hash == name.hash && std::strcmp(entry.name.c_str(), name.name) == 0;
+        }
+
+        SingletonRegistry() = default;
+
+        std::atomic<const Table*> _table{nullptr};  // Current table, read without locks
+        std::vector<std::unique_ptr<Table>> _tables; // Every table ever published
+        std::mutex _writeMutex;                      // Serializes Register
+};
+
+// Registers the LazySingleton instance of T under `name`; meant for static objects:
+//     static SingletonRegistration<MySingleton, Base> theRegistration("MySingleton");
+template <class T, class Base>
+struct SingletonRegistration 
+{
+    explicit SingletonRegistration(HashedName name)
+    {
+        SingletonRegistry<Base>::Instance().Register(name, LazySingleton<T>::Instance());
+    }
+};
+
 class MazeFactory 
 {
     public:
         static MazeFactory* Instance();
+        // Factory registered under `name` (e.g. "bombed", "enchanted"), or nullptr
+        static MazeFactory* Lookup(HashedName name);
+        virtual ~MazeFactory() = default;
+        virtual const char* Style() const { return "standard"; }
         // existing interface goes here
     protected:
         MazeFactory();
     private:
-        static MazeFactory* _instance;
+        friend class LazySingleton<MazeFactory>;
 };
 
-MazeFactory* MazeFactory::_instance = 0;
 MazeFactory::MazeFactory(){}
 MazeFactory* MazeFactory::Instance () 
 {
-    if (_instance == 0 ) 
+    return LazySingleton<MazeFactory>::Instance();
+}
+
+MazeFactory* MazeFactory::Lookup (HashedName name) 
+{
+    return SingletonRegistry<MazeFactory>::Instance().Lookup(name);
+}
+
+class BombedMazeFactory : public MazeFactory 
+{
+    public:
+        const char* Style() const override { return "bombed"; }
+    protected:
+        BombedMazeFactory() = default;
+    private:
+        friend class LazySingleton<BombedMazeFactory>;
+};
+
+class EnchantedMazeFactory : public MazeFactory 
+{
+    public:
+        const char* Style() const override { return "enchanted"; }
+    protected:
+        EnchantedMazeFactory() = default;
+    private:
+        friend class LazySingleton<EnchantedMazeFactory>;
+};
+
+// Every factory registers itself before main() runs
+static SingletonRegistration<MazeFactory, MazeFactory> theStandardFactory("standard");
+static SingletonRegistration<BombedMazeFactory, MazeFactory> theBombedFactory("bombed");
+static SingletonRegistration<EnchantedMazeFactory, MazeFactory> theEnchantedFactory("enchanted");
+
+// Benchmark helper: ns per Instance() call with `threads` threads calling it concurrently
+template <class GetInstance>
+double NanosecondsPerCall(GetInstance getInstance, unsigned threads, long callsPerThread)
+{
+    std::atomic<std::uintptr_t> sink{0};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) 
     {
-        _instance = new MazeFactory;
+        workers.emplace_back([&] {
+            std::uintptr_t local = 0;
+            for (long i = 0; i < callsPerThread; ++i) 
+            {
+                local ^= reinterpret_cast<std::uintptr_t>(getInstance());
+            }
+            sink ^= local; // Keeps the calls from being optimized away
+        });
     }
-    return _instance;
+    for (auto& worker : workers) 
+    {
+        worker.join();
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (static_cast<double>(callsPerThread) * threads);
 }
 
+struct Counter 
+{
+    Counter() { ++constructions; }
+    static std::atomic<int> constructions;
+};
+std::atomic<int> Counter::constructions{0};
+
 int main()
 {
+    // Many threads racing on the first access still construct exactly one instance
+    std::vector<std::thread> racers;
+    for (int t = 0; t < 8; ++t) 
+    {
+        racers.emplace_back([] { LazySingleton<Counter>::Instance(); });
+    }
+    for (auto& racer : racers) 
+    {
+        racer.join();
+    }
+    std::cout << "Counter constructions: " << Counter::constructions << std::endl;
+
+    // Per-request factory selection: a constant name is hashed at compile time, a runtime one per call
+    constexpr HashedName bombed{"bombed"};
+    std::cout << "Lookup(bombed): " << MazeFactory::Lookup(bombed)->Style() << std::endl;
+    const char* mazeStyle = std::getenv("MAZESTYLE");
+    MazeFactory* selected = MazeFactory::Lookup(mazeStyle);
+    std::cout << "MAZESTYLE selects: " << (selected ? selected : MazeFactory::Instance())->Style() << std::endl;
+    std::cout << "Lookup: " << NanosecondsPerCall([] { return MazeFactory::Lookup(HashedName{"enchanted"}); }, 1, 10000000) << " ns" << std::endl;
+
+    // Steady-state cost of Instance()
+    const long calls = 10000000;
+    for (unsigned threads : {1u, 4u}) 
+    {
+        std::cout << threads << " thread(s):"
+                  << "  LazySingleton " << NanosecondsPerCall([] { return LazySingleton<MazeFactory>::Instance(); }, threads, calls) << " ns"
+                  << ", MeyersSingleton " << NanosecondsPerCall([] { return MeyersSingleton<Counter>::Instance(); }, threads, calls) << " ns"
+                  << ", MutexSingleton " << NanosecondsPerCall([] { return MutexSingleton<Counter>::Instance(); }, threads, calls) << " ns"
+                  << std::endl;
+    }
+
     return 0;
-}
\ No newline at end of file
+}
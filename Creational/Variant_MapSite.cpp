@@ -0,0 +1,321 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+/*
+    Maze sites twice over: the polymorphic MapSite hierarchy used by the Creational examples,
+    and a closed std::variant of the same three sites (as in Behavioral/Visitor/variantApproach.cpp).
+
+    In both, Enter moves a Player as described for the maze game: entering a room puts the
+    player in it, entering an open door takes the player to the room on the other side, and
+    entering a wall (or a closed door) leaves the player where they are.
+*/
+
+// Enum to represent directions for room sides
+enum Direction { North, South, East, West };
+
+class Room;
+
+// Player state changed by entering sites
+struct Player {
+    Room* room = nullptr;      // Current room
+    std::uint64_t doors = 0;   // Doors passed through
+    std::uint64_t bumps = 0;   // Walls and closed doors walked into
+};
+
+// Abstract Product: Base class for all maze components
+class MapSite {
+public:
+    virtual void Enter(Player& player) = 0; // Pure virtual interface method
+    virtual ~MapSite() = default; // Virtual destructor for proper cleanup
+};
+
+// Concrete Product: Room component
+class Room : public MapSite {
+public:
+    Room(int roomNumber) : _roomNumber(roomNumber) {}
+
+    // Get a side of the room based on direction
+    MapSite* GetSide(Direction direction) const {
+        return _sides[direction];
+    }
+
+    // Set a side of the room
+    void SetSide(Direction direction, MapSite* site) {
+        _sides[direction] = site;
+    }
+
+    // Get the room number
+    int GetRoomNumber() const { return _roomNumber; }
+
+    void Enter(Player& player) override { player.room = this; }
+
+private:
+    MapSite* _sides[4] = {}; // Room's sides (4 directions); non-owning, walls may be shared flyweights
+    int _roomNumber;         // Room identifier
+};
+
+// Concrete Product: Door component connecting two rooms
+class Door : public MapSite {
+public:
+    Door(Room* r1, Room* r2, bool isOpen = false) : _room1(r1), _room2(r2), _isOpen(isOpen) {}
+
+    // Get the room on the other side of the door
+    Room* OtherSideFrom(Room* room) {
+        return (room == _room1) ? _room2 : _room1;
+    }
+
+    // Rooms connected by this door, and its state
+    Room* GetRoom1() const { return _room1; }
+    Room* GetRoom2() const { return _room2; }
+    bool IsOpen() const { return _isOpen; }
+
+    void Enter(Player& player) override {
+        if (_isOpen) {
+            player.room = OtherSideFrom(player.room);
+            ++player.doors;
+        } else {
+            ++player.bumps;
+        }
+    }
+
+private:
+    Room* _room1;  // First connected room
+    Room* _room2;  // Second connected room
+    bool _isOpen;  // Door state
+};
+
+// Concrete Product: Wall component
+class Wall : public MapSite {
+public:
+    Wall() = default;
+    void Enter(Player& player) override { ++player.bumps; }
+};
+
+// Flyweight: one shared, stateless instance per wall kind (see Builder.cpp)
+class WallFlyweights {
+public:
+    template <class TWall = Wall>
+    static TWall* Get() {
+        static TWall instance;
+        return &instance;
+    }
+};
+
+// Product: The maze object graph
+class Maze {
+public:
+    Maze() = default;
+
+    // Add a room to the maze
+    void AddRoom(Room* room) { _rooms.push_back(room); }
+
+    // All rooms, in insertion order
+    const std::vector<Room*>& Rooms() const { return _rooms; }
+
+private:
+    std::vector<Room*> _rooms; // Collection of rooms in the maze
+};
+
+/*
+    MapSiteV : A side as a closed set of alternatives instead of a MapSite pointer.
+
+    Rooms and doors live in flat arrays of VariantMaze and are referred to by 32-bit index, so
+    a side is a 4-byte payload plus the variant's discriminator: 8 bytes, the size of the
+    pointer it replaces, but with no object behind walls at all. Enter is a std::visit over
+    the alternatives, which compiles to a switch on the discriminator instead of an indirect
+    call, and the visitor bodies are inlined into the navigation loop.
+*/
+struct RoomRef { std::uint32_t index; };  // A room of the VariantMaze (open passage)
+struct DoorRef { std::uint32_t index; };  // A door of the VariantMaze
+struct WallTag {};                        // A wall
+
+using MapSiteV = std::variant<RoomRef, DoorRef, WallTag>;
+
+static_assert(sizeof(MapSiteV) <= 8, "a side should fit in 8 bytes");
+
+class VariantMaze {
+public:
+    using RoomId = std::uint32_t;
+
+    struct RoomV {
+        MapSiteV sides[4] = {WallTag{}, WallTag{}, WallTag{}, WallTag{}};
+        int number;
+    };
+
+    struct DoorV {
+        RoomId room1;
+        RoomId room2;
+        bool isOpen;
+    };
+
+    RoomId AddRoom(int roomNumber) {
+        _rooms.push_back(RoomV{{WallTag{}, WallTag{}, WallTag{}, WallTag{}}, roomNumber});
+        return static_cast<RoomId>(_rooms.size() - 1);
+    }
+
+    // Add a door between two rooms; returns the side to store in both rooms
+    MapSiteV AddDoor(RoomId room1, RoomId room2, bool isOpen) {
+        _doors.push_back(DoorV{room1, room2, isOpen});
+        return DoorRef{static_cast<std::uint32_t>(_doors.size() - 1)};
+    }
+
+    const MapSiteV& GetSide(RoomId room, Direction direction) const { return _rooms[room].sides[direction]; }
+    void SetSide(RoomId room, Direction direction, MapSiteV site) { _rooms[room].sides[direction] = site; }
+
+    const DoorV& GetDoor(std::uint32_t door) const { return _doors[door]; }
+    int RoomNumber(RoomId room) const { return _rooms[room].number; }
+    std::size_t RoomCount() const { return _rooms.size(); }
+
+    // Converter from the object graph; rooms get ids in Maze insertion order
+    static VariantMaze FromMaze(const Maze& maze) {
+        VariantMaze result;
+        std::unordered_map<const Room*, RoomId> roomIds;
+        for (const Room* room : maze.Rooms()) {
+            roomIds.emplace(room, result.AddRoom(room->GetRoomNumber()));
+        }
+        std::unordered_map<const Door*, MapSiteV> doorSides;
+        for (const Room* room : maze.Rooms()) {
+            for (int d = North; d <= West; ++d) {
+                Direction direction = static_cast<Direction>(d);
+                MapSite* site = room->GetSide(direction);
+                if (auto* door = dynamic_cast<Door*>(site)) {
+                    auto it = doorSides.find(door);
+                    if (it == doorSides.end()) {
+                        it = doorSides.emplace(door, result.AddDoor(roomIds.at(door->GetRoom1()), roomIds.at(door->GetRoom2()),
+                                                                    door->IsOpen())).first;
+                    }
+                    result.SetSide(roomIds.at(room), direction, it->second);
+                } else if (auto* other = dynamic_cast<Room*>(site)) {
+                    result.SetSide(roomIds.at(room), direction, RoomRef{roomIds.at(other)});
+                }
+            }
+        }
+        return result;
+    }
+
+private:
+    std::vector<RoomV> _rooms; // Rooms, addressed by RoomId
+    std::vector<DoorV> _doors; // Doors, addressed by DoorRef::index
+};
+
+// Player state for the variant representation
+struct PlayerV {
+    VariantMaze::RoomId room = 0;
+    std::uint64_t doors = 0;
+    std::uint64_t bumps = 0;
+};
+
+// Visitor implementing Enter for each alternative
+struct EnterSite {
+    const VariantMaze& maze;
+    PlayerV& player;
+
+    void operator()(RoomRef r) const { player.room = r.index; }
+
+    void operator()(DoorRef d) const {
+        const VariantMaze::DoorV& door = maze.GetDoor(d.index);
+        if (door.isOpen) {
+            player.room = (player.room == door.room1) ? door.room2 : door.room1;
+            ++player.doors;
+        } else {
+            ++player.bumps;
+        }
+    }
+
+    void operator()(WallTag) const { ++player.bumps; }
+};
+
+inline void Enter(const VariantMaze& maze, const MapSiteV& site, PlayerV& player) {
+    std::visit(EnterSite{maze, player}, site);
+}
+
+// Builds a width x height grid: neighbours are joined by a door (mostly open) or separated by a wall
+Maze* CreateRandomGridMaze(int width, int height, std::uint32_t seed) {
+    Maze* maze = new Maze;
+    std::vector<Room*> rooms;
+    for (int n = 0; n < width * height; ++n) {
+        Room* room = new Room(n);
+        Wall* wall = WallFlyweights::Get<Wall>();
+        room->SetSide(North, wall);
+        room->SetSide(South, wall);
+        room->SetSide(East, wall);
+        room->SetSide(West, wall);
+        maze->AddRoom(room);
+        rooms.push_back(room);
+    }
+    std::uint32_t state = seed;
+    auto next = [&state] {
+        state = state * 1664525u + 1013904223u;
+        return state >> 16;
+    };
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            Room* room = rooms[y * width + x];
+            if (x + 1 < width && next() % 10 < 7) {
+                Room* east = rooms[y * width + x + 1];
+                Door* door = new Door(room, east, next() % 10 < 8);
+                room->SetSide(East, door);
+                east->SetSide(West, door);
+            }
+            if (y + 1 < height && next() % 10 < 7) {
+                Room* south = rooms[(y + 1) * width + x];
+                Door* door = new Door(room, south, next() % 10 < 8);
+                room->SetSide(South, door);
+                south->SetSide(North, door);
+            }
+        }
+    }
+    return maze;
+}
+
+// xorshift64: the same direction sequence for both walks
+struct WalkRandom {
+    std::uint64_t state;
+    Direction Next() {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return static_cast<Direction>(state & 3);
+    }
+};
+
+int main(int argc, char* argv[]) {
+    const std::uint64_t steps = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000ull;
+
+    Maze* maze = CreateRandomGridMaze(512, 512, 42);
+    VariantMaze variantMaze = VariantMaze::FromMaze(*maze);
+
+    // Polymorphic: virtual Enter through MapSite pointers
+    Player player;
+    player.room = maze->Rooms()[0];
+    WalkRandom random{0x9E3779B97F4A7C15ull};
+    auto start = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < steps; ++i) {
+        player.room->GetSide(random.Next())->Enter(player);
+    }
+    double virtualSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Variant: std::visit over MapSiteV
+    PlayerV playerV;
+    random = WalkRandom{0x9E3779B97F4A7C15ull};
+    start = std::chrono::steady_clock::now();
+    for (std::uint64_t i = 0; i < steps; ++i) {
+        Enter(variantMaze, variantMaze.GetSide(playerV.room, random.Next()), playerV);
+    }
+    double variantSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    bool samePath = player.room->GetRoomNumber() == variantMaze.RoomNumber(playerV.room) &&
+                    player.doors == playerV.doors && player.bumps == playerV.bumps;
+    std::cout << "Random walk of " << steps << " steps over " << variantMaze.RoomCount() << " rooms ("
+              << player.doors << " doors passed, " << player.bumps << " bumps)" << std::endl;
+    std::cout << "  virtual MapSite::Enter : " << virtualSeconds * 1e9 / steps << " ns/step" << std::endl;
+    std::cout << "  std::visit on MapSiteV : " << variantSeconds * 1e9 / steps << " ns/step" << std::endl;
+    std::cout << "  walks " << (samePath ? "agree" : "DIFFER") << ", sizeof(MapSiteV) = " << sizeof(MapSiteV) << std::endl;
+
+    return 0;
+}
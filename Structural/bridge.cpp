@@ -1,5 +1,7 @@
 
+#include <atomic>
 #include <iostream>
+#include <mutex>
 
 /*
 
@@ -160,20 +162,30 @@ virtual WindowImp* CreateWindowImp()
     return new XWindowImp();
 }
 
+// Double-checked locking: lock-free once the instance exists (see LazySingleton in Creational/Singleton.cpp)
 static WindowSystemFactory * getInstance()
 {
-    if(!_instance)
+    WindowSystemFactory* instance = _instance.load(std::memory_order_acquire);
+    if(!instance)
     {
-        _instance = new WindowSystemFactory();
+        std::lock_guard<std::mutex> lock(_mutex);
+        instance = _instance.load(std::memory_order_relaxed);
+        if(!instance)
+        {
+            instance = new WindowSystemFactory();
+            _instance.store(instance, std::memory_order_release);
+        }
     }
-    return _instance;
+    return instance;
 }
 protected:
 WindowSystemFactory() {}
-static WindowSystemFactory * _instance;
+static std::atomic<WindowSystemFactory*> _instance;
+static std::mutex _mutex;
 };
 
-WindowSystemFactory* WindowSystemFactory::_instance = nullptr;
+std::atomic<WindowSystemFactory*> WindowSystemFactory::_instance{nullptr};
+std::mutex WindowSystemFactory::_mutex;
 
 // Abstract Interface Class
 class Window {